@@ -1,42 +1,300 @@
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdarg.h>
 #include <errno.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <linux/fiemap.h>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <aio.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <string.h>
 #include <strings.h>
 #include <getopt.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "transpose.h"
+#include <math.h>
+#include <signal.h>
+
+#ifdef HAVE_HDF5
+#include <hdf5.h>
+#endif
 
 //
 
 typedef union {
     FILE        *stream;
     int         fd;
+    struct lossy_handle *lossy;
+#ifdef HAVE_HDF5
+    struct hdf5_handle  *hdf5;
+#endif
 } file_handle_t;
 
 typedef bool (*file_handle_open_t)(file_handle_t *fh, const char *path, bool read_only, bool should_create, bool should_trunc);
 typedef bool (*file_handle_stat_t)(file_handle_t *fh, struct stat *finfo);
 typedef off_t (*file_handle_seek_t)(file_handle_t *fh, off_t offset);
+typedef off_t (*file_handle_tell_t)(file_handle_t *fh);
 typedef ssize_t (*file_handle_read_t)(file_handle_t *fh, void *buffer, size_t buffer_len);
 typedef ssize_t (*file_handle_write_t)(file_handle_t *fh, const void *buffer, size_t buffer_len);
+typedef ssize_t (*file_handle_pread_t)(file_handle_t *fh, void *buffer, size_t buffer_len, off_t offset);
+typedef ssize_t (*file_handle_pwrite_t)(file_handle_t *fh, const void *buffer, size_t buffer_len, off_t offset);
 typedef void (*file_handle_close_t)(file_handle_t *fh);
+typedef int (*file_handle_fileno_t)(file_handle_t *fh);
+typedef bool (*file_handle_clone_t)(file_handle_t *fh, file_handle_t *clone);
+
+/*
+ * Access-pattern hints for a byte range of a file (len 0 extends to the end
+ * of the file):
+ */
+typedef enum {
+    io_hint_normal = 0,
+    io_hint_sequential,
+    io_hint_random,
+    io_hint_will_need,
+    io_hint_dont_need
+} io_hint_t;
+
+typedef void (*file_handle_hint_t)(file_handle_t *fh, io_hint_t hint, off_t offset, off_t len);
+typedef bool (*file_handle_option_t)(const char *key, const char *value);
+
+/*
+ * An asynchronous transfer of buffer_len bytes at offset:  it is complete
+ * once all bytes were moved, end-of-file was reached (reads only; done is
+ * then short) or an error occurred (error is the errno value).  The backend
+ * reissues short transfers for the remainder itself.
+ */
+typedef struct io_request io_request_t;
+
+struct io_request {
+    file_handle_t           *fh;
+    char                    *buffer;
+    size_t                  buffer_len;
+    off_t                   offset;
+    bool                    is_write;
+    size_t                  done;
+    int                     error;
+    volatile bool           is_complete;
+    struct aiocb            aiocb;
+    io_request_t            *next;
+};
+
+typedef io_request_t* (*file_handle_submit_read_t)(file_handle_t *fh, void *buffer, size_t buffer_len, off_t offset);
+typedef io_request_t* (*file_handle_submit_write_t)(file_handle_t *fh, const void *buffer, size_t buffer_len, off_t offset);
+typedef bool (*file_handle_poll_t)(io_request_t *req);
+typedef int (*file_handle_wait_any_t)(io_request_t **reqs, int n_reqs);
+typedef bool (*file_handle_wait_all_t)(io_request_t **reqs, int n_reqs);
 
+/*
+ * The read and write callbacks may transfer fewer bytes than requested; the
+ * io_transfer_* functions below loop until the request is complete.  The
+ * pread and pwrite callbacks are optional (NULL when the driver has no
+ * positional i/o) and must not move the file position.  The fileno
+ * callback returns the underlying file descriptor, with any buffered data
+ * flushed to it, or -1 if there is none.  The clone callback opens a second
+ * handle on the same file with a file position (and buffer) of its own, to
+ * be closed with the close callback; each worker thread of a parallel
+ * transfer gets one so seek+read never races on a shared position.  The
+ * hint callback passes an access-pattern hint to the kernel; hints are
+ * advisory and failures are ignored.  The option callback (NULL if the
+ * driver has no tunables) sets a driver tunable from a -D key=value pair
+ * (value is NULL for a bare key) before any file is opened; it returns
+ * false for an unknown key or an invalid value.
+ *
+ * The submit_read and submit_write callbacks start a transfer and return its
+ * request (NULL with errno set if it could not be started); poll returns
+ * true once the request is complete, wait_any blocks until one of the
+ * requests is complete and returns its index, and wait_all blocks until all
+ * of them are and returns false (errno set) if any failed.  Requests are
+ * released with io_request_free() once complete.  The fd and stream drivers
+ * have a synchronous shim:  the transfer is done by the submit callback (for
+ * stream at the file position, which it moves) and the request is returned
+ * already complete.
+ */
 typedef struct {
     file_handle_open_t      open;
     file_handle_stat_t      stat;
     file_handle_seek_t      seek;
+    file_handle_tell_t      tell;
     file_handle_read_t      read;
     file_handle_write_t     write;
+    file_handle_pread_t     pread;
+    file_handle_pwrite_t    pwrite;
     file_handle_close_t     close;
+    file_handle_fileno_t    fileno;
+    file_handle_clone_t     clone;
+    file_handle_hint_t      hint;
+    file_handle_option_t    option;
+    file_handle_submit_read_t   submit_read;
+    file_handle_submit_write_t  submit_write;
+    file_handle_poll_t      poll;
+    file_handle_wait_any_t  wait_any;
+    file_handle_wait_all_t  wait_all;
 } file_handle_callbacks;
 
 //
 
+io_request_t*
+io_request_alloc(
+    file_handle_t           *fh,
+    const void              *buffer,
+    size_t                  buffer_len,
+    off_t                   offset,
+    bool                    is_write
+)
+{
+    io_request_t            *req = (io_request_t*)calloc(1, sizeof(io_request_t));
+    
+    if ( req ) {
+        req->fh = fh;
+        req->buffer = (char*)buffer;
+        req->buffer_len = buffer_len;
+        req->offset = offset;
+        req->is_write = is_write;
+    }
+    return req;
+}
+
+void
+io_request_free(
+    io_request_t            *req
+)
+{
+    free((void*)req);
+}
+
+/*
+ * Account for one transfer that returned n (bytes moved, or -errno); returns
+ * true if the request is now finished, false if the remainder must be
+ * reissued.
+ */
+static bool
+io_request_advance(
+    io_request_t            *req,
+    ssize_t                 n
+)
+{
+    if ( (n == -EINTR) || (n == -EAGAIN) ) return false;
+    if ( n < 0 ) {
+        req->error = -n;
+    } else if ( n == 0 ) {
+        if ( req->is_write ) req->error = EIO;
+    } else {
+        req->done += n;
+        if ( req->done < req->buffer_len ) return false;
+    }
+    return true;
+}
+
+/*
+ * The synchronous shim:  xfer moves some of the remaining bytes of the
+ * request, returning the count or -1 with errno set.
+ */
+static io_request_t*
+io_request_run_sync(
+    io_request_t            *req,
+    ssize_t                 (*xfer)(io_request_t *req)
+)
+{
+    if ( req ) {
+        ssize_t             n;
+        
+        do {
+            n = xfer(req);
+        } while ( ! io_request_advance(req, (n < 0) ? -errno : n) );
+        req->is_complete = true;
+    }
+    return req;
+}
+
+bool
+io_request_poll_sync(
+    io_request_t            *req
+)
+{
+    return req->is_complete;
+}
+
+int
+io_request_wait_any_sync(
+    io_request_t            **reqs,
+    int                     n_reqs
+)
+{
+    return (n_reqs > 0) ? 0 : -1;
+}
+
+/*
+ * Wait for each request in turn with the driver's wait_any and report the
+ * first error.
+ */
+static bool
+io_request_wait_all_with(
+    file_handle_wait_any_t  wait_any,
+    io_request_t            **reqs,
+    int                     n_reqs
+)
+{
+    int                     i, error = 0;
+    
+    for ( i = 0; i < n_reqs; i++ ) {
+        wait_any(&reqs[i], 1);
+        if ( reqs[i]->error && ! error ) error = reqs[i]->error;
+    }
+    if ( error ) {
+        errno = error;
+        return false;
+    }
+    return true;
+}
+
+bool
+io_request_wait_all_sync(
+    io_request_t            **reqs,
+    int                     n_reqs
+)
+{
+    return io_request_wait_all_with(io_request_wait_any_sync, reqs, n_reqs);
+}
+
+/*
+ * Driver options take boolean values as 1/0, yes/no, true/false or on/off; a
+ * bare key (NULL value) means true.
+ */
+static bool
+file_handle_option_bool(
+    const char      *value,
+    bool            *b
+)
+{
+    if ( ! value || ! strcasecmp(value, "1") || ! strcasecmp(value, "yes") || ! strcasecmp(value, "true") || ! strcasecmp(value, "on") ) {
+        *b = true;
+    } else if ( ! strcasecmp(value, "0") || ! strcasecmp(value, "no") || ! strcasecmp(value, "false") || ! strcasecmp(value, "off") ) {
+        *b = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//
+
 bool
 file_handle_open_fd(
     file_handle_t   *fh,
@@ -74,6 +332,14 @@ file_handle_seek_fd(
     return lseek(fh->fd, offset, SEEK_SET);
 }
 
+off_t
+file_handle_tell_fd(
+    file_handle_t   *fh
+)
+{
+    return lseek(fh->fd, 0, SEEK_CUR);
+}
+
 ssize_t
 file_handle_read_fd(
     file_handle_t   *fh,
@@ -94,6 +360,28 @@ file_handle_write_fd(
     return write(fh->fd, buffer, buffer_len);
 }
 
+ssize_t
+file_handle_pread_fd(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return pread(fh->fd, buffer, buffer_len, offset);
+}
+
+ssize_t
+file_handle_pwrite_fd(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return pwrite(fh->fd, buffer, buffer_len, offset);
+}
+
 void
 file_handle_close_fd(
     file_handle_t   *fh
@@ -105,17 +393,239 @@ file_handle_close_fd(
     }
 }
 
+int
+file_handle_fileno_fd(
+    file_handle_t   *fh
+)
+{
+    return fh->fd;
+}
+
+/*
+ * A new open file description for the same file, reopened through /proc with
+ * the original access mode; where /proc is unavailable the descriptor is
+ * dup()'ed, which shares the file position (still fine for positional i/o).
+ */
+static int
+file_handle_reopen_fd(
+    int             fd
+)
+{
+    char            path[64];
+    int             oflag = fcntl(fd, F_GETFL), new_fd;
+    
+    if ( oflag < 0 ) return -1;
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    if ( (new_fd = open(path, oflag & ~O_APPEND)) >= 0 ) return new_fd;
+    return dup(fd);
+}
+
+bool
+file_handle_clone_fd(
+    file_handle_t   *fh,
+    file_handle_t   *clone
+)
+{
+    clone->fd = file_handle_reopen_fd(fh->fd);
+    return (clone->fd >= 0) ? true : false;
+}
+
+/*
+ * Hints map onto posix_fadvise(); a will-need range is handed to readahead()
+ * first, which queues the reads right away rather than at the kernel's
+ * discretion.  Dropping a range also starts writeback of its dirty pages.
+ */
+static void
+file_handle_advise(
+    int             fd,
+    io_hint_t       hint,
+    off_t           offset,
+    off_t           len
+)
+{
+    switch ( hint ) {
+        case io_hint_normal:
+            posix_fadvise(fd, offset, len, POSIX_FADV_NORMAL);
+            break;
+        case io_hint_sequential:
+            posix_fadvise(fd, offset, len, POSIX_FADV_SEQUENTIAL);
+            break;
+        case io_hint_random:
+            posix_fadvise(fd, offset, len, POSIX_FADV_RANDOM);
+            break;
+        case io_hint_will_need:
+            if ( (len == 0) || (readahead(fd, offset, len) != 0) ) posix_fadvise(fd, offset, len, POSIX_FADV_WILLNEED);
+            break;
+        case io_hint_dont_need:
+            posix_fadvise(fd, offset, len, POSIX_FADV_DONTNEED);
+            break;
+    }
+}
+
+void
+file_handle_hint_fd(
+    file_handle_t   *fh,
+    io_hint_t       hint,
+    off_t           offset,
+    off_t           len
+)
+{
+    file_handle_advise(fh->fd, hint, offset, len);
+}
+
+static ssize_t
+file_handle_xfer_fd(
+    io_request_t    *req
+)
+{
+    if ( req->is_write ) return pwrite(req->fh->fd, req->buffer + req->done, req->buffer_len - req->done, req->offset + req->done);
+    return pread(req->fh->fd, req->buffer + req->done, req->buffer_len - req->done, req->offset + req->done);
+}
+
+io_request_t*
+file_handle_submit_read_fd(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return io_request_run_sync(io_request_alloc(fh, buffer, buffer_len, offset, false), file_handle_xfer_fd);
+}
+
+io_request_t*
+file_handle_submit_write_fd(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return io_request_run_sync(io_request_alloc(fh, buffer, buffer_len, offset, true), file_handle_xfer_fd);
+}
+
 static file_handle_callbacks file_handle_callbacks_fd = {
         file_handle_open_fd,
         file_handle_stat_fd,
         file_handle_seek_fd,
+        file_handle_tell_fd,
         file_handle_read_fd,
         file_handle_write_fd,
-        file_handle_close_fd
+        file_handle_pread_fd,
+        file_handle_pwrite_fd,
+        file_handle_close_fd,
+        file_handle_fileno_fd,
+        file_handle_clone_fd,
+        file_handle_hint_fd,
+        NULL,
+        file_handle_submit_read_fd,
+        file_handle_submit_write_fd,
+        io_request_poll_sync,
+        io_request_wait_any_sync,
+        io_request_wait_all_sync
     };
 
 //
 
+bool string_to_memory_size(const char *s, size_t *bytes);
+
+/*
+ * Stream driver tunables:  -D buffer=<size> gives every stream a buffer of
+ * that size (0 keeps the C library's choice) and -D mode=full|line|none
+ * selects the setvbuf() buffering mode.  Buffers allocated here are tracked
+ * per stream and freed when it is closed.
+ */
+typedef struct {
+    size_t          buffer_size;
+    int             buffer_mode;
+} stream_config_t;
+
+static stream_config_t stream_config = {
+        0,
+        _IOFBF
+    };
+
+typedef struct stream_buffer {
+    FILE                    *stream;
+    char                    *buffer;
+    struct stream_buffer    *next;
+} stream_buffer_t;
+
+static stream_buffer_t *stream_buffers = NULL;
+static pthread_mutex_t stream_buffers_lock = PTHREAD_MUTEX_INITIALIZER;
+
+bool
+file_handle_option_stream(
+    const char      *key,
+    const char      *value
+)
+{
+    if ( ! strcasecmp(key, "buffer") ) return (value && string_to_memory_size(value, &stream_config.buffer_size)) ? true : false;
+    if ( ! strcasecmp(key, "mode") && value ) {
+        if ( ! strcasecmp(value, "full") ) {
+            stream_config.buffer_mode = _IOFBF;
+        } else if ( ! strcasecmp(value, "line") ) {
+            stream_config.buffer_mode = _IOLBF;
+        } else if ( ! strcasecmp(value, "none") ) {
+            stream_config.buffer_mode = _IONBF;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Apply the buffering tunables to a newly-opened stream (before any i/o on
+ * it, as setvbuf() requires).
+ */
+static void
+file_handle_setvbuf_stream(
+    FILE            *stream
+)
+{
+    stream_buffer_t *B;
+    
+    if ( (stream_config.buffer_mode == _IONBF) || ! stream_config.buffer_size ) {
+        if ( stream_config.buffer_mode != _IOFBF ) setvbuf(stream, NULL, stream_config.buffer_mode, 0);
+        return;
+    }
+    //
+    // glibc ignores the size when setvbuf() is not given a buffer:
+    //
+    if ( ! (B = (stream_buffer_t*)malloc(sizeof(stream_buffer_t))) || ! (B->buffer = (char*)malloc(stream_config.buffer_size)) ) {
+        free((void*)B);
+        printf("WARNING:  unable to allocate a stream buffer of %lu bytes, default buffering used\n", (unsigned long)stream_config.buffer_size);
+        return;
+    }
+    setvbuf(stream, B->buffer, stream_config.buffer_mode, stream_config.buffer_size);
+    B->stream = stream;
+    pthread_mutex_lock(&stream_buffers_lock);
+    B->next = stream_buffers;
+    stream_buffers = B;
+    pthread_mutex_unlock(&stream_buffers_lock);
+}
+
+static void
+file_handle_free_buffer_stream(
+    FILE            *stream
+)
+{
+    stream_buffer_t *B, **prev;
+    
+    pthread_mutex_lock(&stream_buffers_lock);
+    for ( prev = &stream_buffers; (B = *prev); prev = &B->next ) {
+        if ( B->stream == stream ) {
+            *prev = B->next;
+            free((void*)B->buffer);
+            free((void*)B);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&stream_buffers_lock);
+}
+
 bool
 file_handle_open_stream(
     file_handle_t   *fh,
@@ -139,9 +649,11 @@ file_handle_open_stream(
     if ( read_only ) {
         fh->stream = fopen(path, "rb");
     } else {
-        fh->stream = fopen(path, "wb+");
+        // An existing file must not be truncated by the mode string:
+        fh->stream = fopen(path, should_create ? "wb+" : "rb+");
         if ( fh->stream && should_trunc ) ftruncate(fileno(fh->stream), 0);
     }
+    if ( fh->stream ) file_handle_setvbuf_stream(fh->stream);
     return fh->stream ? true : false;
 }
 
@@ -164,6 +676,14 @@ file_handle_seek_stream(
     return -1;
 }
 
+off_t
+file_handle_tell_stream(
+    file_handle_t   *fh
+)
+{
+    return ftello(fh->stream);
+}
+
 ssize_t
 file_handle_read_stream(
     file_handle_t   *fh,
@@ -171,10 +691,11 @@ file_handle_read_stream(
     size_t          buffer_len
 )
 {
-    size_t          n_items = fread(buffer, buffer_len, 1, fh->stream);
+    size_t          n_bytes = fread(buffer, 1, buffer_len, fh->stream);
     
-    if ( n_items == 1 ) return buffer_len;
+    if ( n_bytes > 0 ) return n_bytes;
     if ( feof(fh->stream) ) return 0;
+    clearerr(fh->stream);
     return -1;
 }
 
@@ -185,10 +706,11 @@ file_handle_write_stream(
     size_t          buffer_len
 )
 {
-    size_t          n_items = fwrite(buffer, buffer_len, 1, fh->stream);
+    size_t          n_bytes = fwrite(buffer, 1, buffer_len, fh->stream);
     
-    if ( n_items == 1 ) return buffer_len;
+    if ( n_bytes > 0 ) return n_bytes;
     if ( feof(fh->stream) ) return 0;
+    clearerr(fh->stream);
     return -1;
 }
 
@@ -199,17 +721,101 @@ file_handle_close_stream(
 {
     if ( fh->stream >= 0 ) {
         fclose(fh->stream);
+        file_handle_free_buffer_stream(fh->stream);
         fh->stream = NULL;
     }
 }
 
+int
+file_handle_fileno_stream(
+    file_handle_t   *fh
+)
+{
+    if ( ! fh->stream || (fflush(fh->stream) != 0) ) return -1;
+    return fileno(fh->stream);
+}
+
+bool
+file_handle_clone_stream(
+    file_handle_t   *fh,
+    file_handle_t   *clone
+)
+{
+    int             fd = file_handle_fileno_stream(fh), new_fd;
+    
+    if ( (fd < 0) || ((new_fd = file_handle_reopen_fd(fd)) < 0) ) return false;
+    if ( ! (clone->stream = fdopen(new_fd, ((fcntl(new_fd, F_GETFL) & O_ACCMODE) == O_RDONLY) ? "rb" : "rb+")) ) {
+        close(new_fd);
+        return false;
+    }
+    file_handle_setvbuf_stream(clone->stream);
+    return true;
+}
+
+void
+file_handle_hint_stream(
+    file_handle_t   *fh,
+    io_hint_t       hint,
+    off_t           offset,
+    off_t           len
+)
+{
+    int             fd = file_handle_fileno_stream(fh);
+    
+    if ( fd >= 0 ) file_handle_advise(fd, hint, offset, len);
+}
+
+static ssize_t
+file_handle_xfer_stream(
+    io_request_t    *req
+)
+{
+    if ( file_handle_seek_stream(req->fh, req->offset + req->done) < 0 ) return -1;
+    if ( req->is_write ) return file_handle_write_stream(req->fh, req->buffer + req->done, req->buffer_len - req->done);
+    return file_handle_read_stream(req->fh, req->buffer + req->done, req->buffer_len - req->done);
+}
+
+io_request_t*
+file_handle_submit_read_stream(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return io_request_run_sync(io_request_alloc(fh, buffer, buffer_len, offset, false), file_handle_xfer_stream);
+}
+
+io_request_t*
+file_handle_submit_write_stream(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return io_request_run_sync(io_request_alloc(fh, buffer, buffer_len, offset, true), file_handle_xfer_stream);
+}
+
 static file_handle_callbacks file_handle_callbacks_stream = {
         file_handle_open_stream,
         file_handle_stat_stream,
         file_handle_seek_stream,
+        file_handle_tell_stream,
         file_handle_read_stream,
         file_handle_write_stream,
-        file_handle_close_stream
+        NULL,
+        NULL,
+        file_handle_close_stream,
+        file_handle_fileno_stream,
+        file_handle_clone_stream,
+        file_handle_hint_stream,
+        file_handle_option_stream,
+        file_handle_submit_read_stream,
+        file_handle_submit_write_stream,
+        io_request_poll_sync,
+        io_request_wait_any_sync,
+        io_request_wait_all_sync
     };
 
 //
@@ -222,6 +828,9 @@ typedef enum {
     algorithm_vector_input,
     algorithm_vector_output,
     algorithm_matrix,
+    algorithm_matrix_parallel,
+    algorithm_matrix_uring,
+    algorithm_matrix_async,
     algorithm_max
 } algorithm_t;
 
@@ -232,6 +841,9 @@ static char const* algorithm_names[] = {
         "vector_input",
         "vector_output",
         "matrix",
+        "matrix_parallel",
+        "matrix_uring",
+        "matrix_async",
         NULL
     };
 
@@ -251,174 +863,5337 @@ string_to_algorithm(
 
 //
 
-typedef enum {
-    io_driver_invalid = -1,
-    io_driver_fd = 0,
-    io_driver_stream,
-    io_driver_max
-} io_driver_t;
 
-static char const* io_driver_names[] = {
-        "fd",
-        "stream",
-        NULL
-    };
+/*
+ * The Linux kernel transfers at most 0x7ffff000 bytes in a single read() or
+ * write() call, so no single driver call is ever asked for more than that.
+ */
+#define IO_MAX_SINGLE_TRANSFER      ((size_t)0x7ffff000)
 
-static file_handle_callbacks* io_driver_callbacks[] = {
-        &file_handle_callbacks_fd,
-        &file_handle_callbacks_stream,
-        NULL
+#define IO_TRANSFER_DEFAULT_CHUNK   ((size_t)64 * 1024 * 1024)
+
+typedef struct {
+    size_t          chunk_size;
+    int             n_threads;
+} io_transfer_config_t;
+
+static io_transfer_config_t io_transfer_config = {
+        IO_TRANSFER_DEFAULT_CHUNK,
+        1
     };
 
-io_driver_t
-string_to_io_driver(
-    const char  *s
+/*
+ * Move buffer_len bytes at the current file position in chunks of at most
+ * chunk_size bytes, retrying short transfers and EINTR.  Returns the number
+ * of bytes moved (less than buffer_len only at end-of-file) or -1 on error.
+ */
+static ssize_t
+io_transfer_serial(
+    file_handle_callbacks   *driver,
+    file_handle_t           *fh,
+    void                    *buffer,
+    size_t                  buffer_len,
+    bool                    is_write
 )
 {
-    int         d = 0;
+    size_t                  total = 0;
     
-    while ( io_driver_names[d] ) {
-        if ( strcasecmp(io_driver_names[d], s) == 0 ) return d;
-        d++;
+    while ( total < buffer_len ) {
+        size_t              chunk = buffer_len - total;
+        ssize_t             n;
+        
+        if ( chunk > io_transfer_config.chunk_size ) chunk = io_transfer_config.chunk_size;
+        if ( is_write ) {
+            n = driver->write(fh, (char*)buffer + total, chunk);
+        } else {
+            n = driver->read(fh, (char*)buffer + total, chunk);
+        }
+        if ( n < 0 ) {
+            if ( errno == EINTR ) continue;
+            return -1;
+        }
+        if ( n == 0 ) {
+            if ( is_write ) {
+                errno = EIO;
+                return -1;
+            }
+            break;
+        }
+        total += n;
     }
-    return io_driver_invalid;
+    return total;
 }
 
-//
+typedef struct {
+    file_handle_callbacks   *driver;
+    file_handle_t           *fh;
+    char                    *buffer;
+    size_t                  buffer_len;
+    off_t                   offset;
+    bool                    is_write;
+    int                     thread_idx, n_threads;
+    size_t                  short_at;
+    int                     error;
+} io_transfer_worker_t;
 
-static struct option cli_options[] = {
-        { "help",       no_argument,       0, 'h' },
-        { "input",      required_argument, 0, 'i' },
-        { "output",     required_argument, 0, 'o' },
-        { "n1",         required_argument, 0, '1' },
-        { "n2",         required_argument, 0, '2' },
-        { "n3",         required_argument, 0, '3' },
-        { "exact-dims", no_argument,       0, 'x' },
-        { "algorithm",  required_argument, 0, 'a' },
-        { "io-driver",  required_argument, 0, 'd' },
-        { "init-input", no_argument,       0, 'I' },
-        { NULL, 0, 0, 0 }
+static void*
+io_transfer_worker(
+    void                    *context
+)
+{
+    io_transfer_worker_t    *W = (io_transfer_worker_t*)context;
+    size_t                  chunk_size = io_transfer_config.chunk_size;
+    size_t                  base;
+    
+    W->short_at = W->buffer_len;
+    W->error = 0;
+    for ( base = W->thread_idx * chunk_size; base < W->buffer_len; base += W->n_threads * chunk_size ) {
+        size_t              chunk_end = base + chunk_size, done = base;
+        
+        if ( chunk_end > W->buffer_len ) chunk_end = W->buffer_len;
+        while ( done < chunk_end ) {
+            ssize_t         n;
+            
+            if ( ! W->driver->pread ) {
+                //
+                // Without positional i/o W->fh is the worker's own clone:
+                //
+                if ( W->driver->seek(W->fh, W->offset + done) < 0 ) {
+                    n = -1;
+                } else if ( W->is_write ) {
+                    n = W->driver->write(W->fh, W->buffer + done, chunk_end - done);
+                } else {
+                    n = W->driver->read(W->fh, W->buffer + done, chunk_end - done);
+                }
+            } else if ( W->is_write ) {
+                n = W->driver->pwrite(W->fh, W->buffer + done, chunk_end - done, W->offset + done);
+            } else {
+                n = W->driver->pread(W->fh, W->buffer + done, chunk_end - done, W->offset + done);
+            }
+            if ( n < 0 ) {
+                if ( errno == EINTR ) continue;
+                W->error = errno;
+                return NULL;
+            }
+            if ( n == 0 ) {
+                if ( W->is_write ) {
+                    W->error = EIO;
+                    return NULL;
+                }
+                if ( done < W->short_at ) W->short_at = done;
+                return NULL;
+            }
+            done += n;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * The handle a worker thread should use:  a clone of fh if the driver can
+ * make one (clone is then set and must be closed), otherwise fh itself if
+ * the driver has positional i/o, otherwise NULL.
+ */
+static file_handle_t*
+io_transfer_worker_handle(
+    file_handle_callbacks   *driver,
+    file_handle_t           *fh,
+    file_handle_t           *clone,
+    bool                    *is_cloned
+)
+{
+    *is_cloned = (driver->clone && driver->clone(fh, clone)) ? true : false;
+    if ( *is_cloned ) return clone;
+    return driver->pread ? fh : NULL;
+}
+
+/*
+ * Split the transfer into chunks issued concurrently, each worker on its own
+ * cloned handle; the file position is left just past the transferred bytes,
+ * as with the serial transfer.
+ */
+static ssize_t
+io_transfer_parallel(
+    file_handle_callbacks   *driver,
+    file_handle_t           *fh,
+    void                    *buffer,
+    size_t                  buffer_len,
+    bool                    is_write
+)
+{
+    int                     n_threads = io_transfer_config.n_threads, n_handles, n_started, t;
+    size_t                  n_chunks = (buffer_len + io_transfer_config.chunk_size - 1) / io_transfer_config.chunk_size;
+    io_transfer_worker_t    workers[n_threads];
+    pthread_t               threads[n_threads];
+    file_handle_t           clones[n_threads];
+    bool                    is_cloned[n_threads];
+    off_t                   offset = driver->tell(fh);
+    size_t                  total = buffer_len;
+    int                     error = 0;
+    
+    if ( offset < 0 ) return -1;
+    if ( n_chunks < n_threads ) n_threads = n_chunks;
+    n_handles = n_threads;
+    for ( t = 0; t < n_threads; t++ ) {
+        file_handle_t       *worker_fh = io_transfer_worker_handle(driver, fh, &clones[t], &is_cloned[t]);
+        
+        if ( ! worker_fh ) {
+            error = errno;
+            while ( t-- > 0 ) if ( is_cloned[t] ) driver->close(&clones[t]);
+            errno = error;
+            return -1;
+        }
+        workers[t] = (io_transfer_worker_t){ driver, worker_fh, (char*)buffer, buffer_len, offset, is_write, t, n_threads, buffer_len, 0 };
+    }
+    for ( t = 1, n_started = n_threads; t < n_threads; t++ ) {
+        int                 prc = pthread_create(&threads[t], NULL, io_transfer_worker, &workers[t]);
+        
+        if ( prc != 0 ) {
+            //
+            // The chunks assigned to the missing workers are not moved, so
+            // the transfer fails:
+            //
+            workers[t].error = prc;
+            n_started = t;
+            n_threads = t + 1;
+            break;
+        }
+    }
+    io_transfer_worker(&workers[0]);
+    for ( t = 1; t < n_started; t++ ) pthread_join(threads[t], NULL);
+    for ( t = 0; t < n_handles; t++ ) if ( is_cloned[t] ) driver->close(&clones[t]);
+    for ( t = 0; t < n_threads; t++ ) {
+        if ( workers[t].error ) error = workers[t].error;
+        if ( workers[t].short_at < total ) total = workers[t].short_at;
+    }
+    if ( error ) {
+        errno = error;
+        return -1;
+    }
+    if ( driver->seek(fh, offset + total) < 0 ) return -1;
+    return total;
+}
+
+ssize_t
+io_transfer_read(
+    file_handle_callbacks   *driver,
+    file_handle_t           *fh,
+    void                    *buffer,
+    size_t                  buffer_len
+)
+{
+    if ( (io_transfer_config.n_threads > 1) && (driver->pread || driver->clone) && (buffer_len > io_transfer_config.chunk_size) ) {
+        return io_transfer_parallel(driver, fh, buffer, buffer_len, false);
+    }
+    return io_transfer_serial(driver, fh, buffer, buffer_len, false);
+}
+
+ssize_t
+io_transfer_write(
+    file_handle_callbacks   *driver,
+    file_handle_t           *fh,
+    const void              *buffer,
+    size_t                  buffer_len
+)
+{
+    if ( (io_transfer_config.n_threads > 1) && (driver->pwrite || driver->clone) && (buffer_len > io_transfer_config.chunk_size) ) {
+        return io_transfer_parallel(driver, fh, (void*)buffer, buffer_len, true);
+    }
+    return io_transfer_serial(driver, fh, (void*)buffer, buffer_len, true);
+}
+
+/*
+ * Move buffer_len bytes at the given file offset in chunks of at most
+ * chunk_size bytes.  With positional i/o the file position is not used, so
+ * several threads may share the file handle; otherwise fh is seeked and
+ * must be private to the caller (e.g. a clone).
+ */
+ssize_t
+io_transfer_at(
+    file_handle_callbacks   *driver,
+    file_handle_t           *fh,
+    void                    *buffer,
+    size_t                  buffer_len,
+    off_t                   offset,
+    bool                    is_write
+)
+{
+    io_transfer_worker_t    W = { driver, fh, (char*)buffer, buffer_len, offset, is_write, 0, 1, buffer_len, 0 };
+    
+    io_transfer_worker(&W);
+    if ( W.error ) {
+        errno = W.error;
+        return -1;
+    }
+    return W.short_at;
+}
+
+//
+
+/*
+ * Minimal io_uring access through the raw system calls (no liburing):  the
+ * submission and completion rings are mapped into the process and shared
+ * with the kernel, with head/tail updates ordered by acquire/release
+ * atomics.  With SQPOLL a kernel thread consumes the submission ring, so
+ * submitting normally needs no system call at all.
+ */
+typedef struct {
+    int                     fd;
+    bool                    sqpoll;
+    unsigned                sq_entries, cq_entries;
+    unsigned                *sq_head, *sq_tail, *sq_mask, *sq_flags, *sq_array;
+    unsigned                *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe     *sqes;
+    struct io_uring_cqe     *cqes;
+    void                    *sq_ptr, *cq_ptr;
+    size_t                  sq_len, cq_len, sqes_len;
+    unsigned                sq_pending;
+} uring_t;
+
+#define URING_SQPOLL_IDLE_MSEC      1000
+#define URING_MAX_ENTRIES           4096
+
+static inline int
+uring_sys_enter(
+    int                     fd,
+    unsigned                to_submit,
+    unsigned                min_complete,
+    unsigned                flags
+)
+{
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static inline int
+uring_sys_register(
+    int                     fd,
+    unsigned                opcode,
+    const void              *arg,
+    unsigned                nr_args
+)
+{
+    return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+bool
+uring_init(
+    uring_t                 *R,
+    unsigned                entries,
+    bool                    sqpoll
+)
+{
+    struct io_uring_params  params;
+    
+    memset(R, 0, sizeof(*R));
+    memset(&params, 0, sizeof(params));
+    if ( sqpoll ) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = URING_SQPOLL_IDLE_MSEC;
+    }
+    if ( (R->fd = syscall(__NR_io_uring_setup, entries, &params)) < 0 ) return false;
+    R->sqpoll = sqpoll;
+    R->sq_entries = params.sq_entries;
+    R->cq_entries = params.cq_entries;
+    R->sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    R->cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if ( params.features & IORING_FEAT_SINGLE_MMAP ) {
+        if ( R->cq_len > R->sq_len ) R->sq_len = R->cq_len;
+        R->cq_len = R->sq_len;
+    }
+    R->sq_ptr = mmap(NULL, R->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, R->fd, IORING_OFF_SQ_RING);
+    if ( R->sq_ptr == MAP_FAILED ) goto fail_close;
+    if ( params.features & IORING_FEAT_SINGLE_MMAP ) {
+        R->cq_ptr = R->sq_ptr;
+    } else {
+        R->cq_ptr = mmap(NULL, R->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, R->fd, IORING_OFF_CQ_RING);
+        if ( R->cq_ptr == MAP_FAILED ) goto fail_sq;
+    }
+    R->sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+    R->sqes = (struct io_uring_sqe*)mmap(NULL, R->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, R->fd, IORING_OFF_SQES);
+    if ( R->sqes == MAP_FAILED ) goto fail_cq;
+    
+    R->sq_head = (unsigned*)((char*)R->sq_ptr + params.sq_off.head);
+    R->sq_tail = (unsigned*)((char*)R->sq_ptr + params.sq_off.tail);
+    R->sq_mask = (unsigned*)((char*)R->sq_ptr + params.sq_off.ring_mask);
+    R->sq_flags = (unsigned*)((char*)R->sq_ptr + params.sq_off.flags);
+    R->sq_array = (unsigned*)((char*)R->sq_ptr + params.sq_off.array);
+    R->cq_head = (unsigned*)((char*)R->cq_ptr + params.cq_off.head);
+    R->cq_tail = (unsigned*)((char*)R->cq_ptr + params.cq_off.tail);
+    R->cq_mask = (unsigned*)((char*)R->cq_ptr + params.cq_off.ring_mask);
+    R->cqes = (struct io_uring_cqe*)((char*)R->cq_ptr + params.cq_off.cqes);
+    return true;
+    
+fail_cq:
+    if ( R->cq_ptr != R->sq_ptr ) munmap(R->cq_ptr, R->cq_len);
+fail_sq:
+    munmap(R->sq_ptr, R->sq_len);
+fail_close:
+    close(R->fd);
+    R->fd = -1;
+    return false;
+}
+
+void
+uring_destroy(
+    uring_t                 *R
+)
+{
+    if ( R->fd < 0 ) return;
+    munmap(R->sqes, R->sqes_len);
+    if ( R->cq_ptr != R->sq_ptr ) munmap(R->cq_ptr, R->cq_len);
+    munmap(R->sq_ptr, R->sq_len);
+    close(R->fd);
+    R->fd = -1;
+}
+
+/*
+ * Returns a cleared submission entry at the tail of the ring, or NULL if the
+ * ring is full; it is queued by the next uring_submit().
+ */
+struct io_uring_sqe*
+uring_get_sqe(
+    uring_t                 *R
+)
+{
+    unsigned                tail = *R->sq_tail + R->sq_pending, idx;
+    
+    if ( tail - __atomic_load_n(R->sq_head, __ATOMIC_ACQUIRE) >= R->sq_entries ) return NULL;
+    idx = tail & *R->sq_mask;
+    R->sq_array[idx] = idx;
+    R->sq_pending++;
+    memset(&R->sqes[idx], 0, sizeof(struct io_uring_sqe));
+    return &R->sqes[idx];
+}
+
+static inline void
+uring_prep_rw(
+    struct io_uring_sqe     *sqe,
+    int                     opcode,
+    int                     fd,
+    void                    *buffer,
+    size_t                  buffer_len,
+    off_t                   offset,
+    int                     buf_index,
+    bool                    fixed_file,
+    unsigned long long      user_data
+)
+{
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long long)(uintptr_t)buffer;
+    sqe->len = buffer_len;
+    sqe->off = offset;
+    sqe->buf_index = (buf_index >= 0) ? buf_index : 0;
+    sqe->flags = fixed_file ? IOSQE_FIXED_FILE : 0;
+    sqe->user_data = user_data;
+}
+
+/*
+ * Publish the queued entries and, if wait_nr > 0, block until at least that
+ * many completions are available.
+ */
+int
+uring_submit(
+    uring_t                 *R,
+    unsigned                wait_nr
+)
+{
+    unsigned                to_submit = R->sq_pending, flags = 0;
+    int                     rc;
+    
+    if ( to_submit ) {
+        __atomic_store_n(R->sq_tail, *R->sq_tail + to_submit, __ATOMIC_RELEASE);
+        R->sq_pending = 0;
+    }
+    if ( R->sqpoll ) {
+        //
+        // The kernel thread picks the entries up itself unless it has gone
+        // idle and needs waking:
+        //
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if ( __atomic_load_n(R->sq_flags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP ) flags |= IORING_ENTER_SQ_WAKEUP;
+        to_submit = 0;
+        if ( ! flags && ! wait_nr ) return 0;
+    } else if ( ! to_submit && ! wait_nr ) {
+        return 0;
+    }
+    if ( wait_nr ) flags |= IORING_ENTER_GETEVENTS;
+    do {
+        rc = uring_sys_enter(R->fd, to_submit, wait_nr, flags);
+    } while ( (rc < 0) && (errno == EINTR) );
+    return rc;
+}
+
+/*
+ * Returns the next completion (to be released with uring_cqe_seen()) or NULL
+ * if none is ready.
+ */
+static inline struct io_uring_cqe*
+uring_peek_cqe(
+    uring_t                 *R
+)
+{
+    unsigned                head = *R->cq_head;
+    
+    if ( head == __atomic_load_n(R->cq_tail, __ATOMIC_ACQUIRE) ) return NULL;
+    return &R->cqes[head & *R->cq_mask];
+}
+
+static inline void
+uring_cqe_seen(
+    uring_t                 *R
+)
+{
+    __atomic_store_n(R->cq_head, *R->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+//
+
+/*
+ * Asynchronous drivers:  these are the fd driver with a real backend behind
+ * the submit/poll/wait callbacks -- POSIX AIO, a pool of worker threads
+ * doing pread/pwrite, or a shared io_uring.
+ */
+#define IO_POOL_DEFAULT_THREADS     4
+#define IO_POOL_MAX_THREADS         256
+#define URING_DRIVER_ENTRIES        256
+
+static bool
+file_handle_aio_start(
+    io_request_t    *req
+)
+{
+    size_t          len = req->buffer_len - req->done;
+    
+    if ( len > IO_MAX_SINGLE_TRANSFER ) len = IO_MAX_SINGLE_TRANSFER;
+    memset(&req->aiocb, 0, sizeof(req->aiocb));
+    req->aiocb.aio_fildes = req->fh->fd;
+    req->aiocb.aio_buf = req->buffer + req->done;
+    req->aiocb.aio_nbytes = len;
+    req->aiocb.aio_offset = req->offset + req->done;
+    return ((req->is_write ? aio_write(&req->aiocb) : aio_read(&req->aiocb)) == 0) ? true : false;
+}
+
+static io_request_t*
+file_handle_submit_aio(
+    io_request_t    *req
+)
+{
+    if ( req && ! file_handle_aio_start(req) ) {
+        int         error = errno;
+        
+        io_request_free(req);
+        errno = error;
+        return NULL;
+    }
+    return req;
+}
+
+io_request_t*
+file_handle_submit_read_aio(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return file_handle_submit_aio(io_request_alloc(fh, buffer, buffer_len, offset, false));
+}
+
+io_request_t*
+file_handle_submit_write_aio(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return file_handle_submit_aio(io_request_alloc(fh, buffer, buffer_len, offset, true));
+}
+
+bool
+file_handle_poll_aio(
+    io_request_t    *req
+)
+{
+    int             rc;
+    
+    if ( req->is_complete ) return true;
+    if ( (rc = aio_error(&req->aiocb)) == EINPROGRESS ) return false;
+    if ( ! io_request_advance(req, rc ? -rc : aio_return(&req->aiocb)) ) {
+        if ( file_handle_aio_start(req) ) return false;
+        req->error = errno;
+    }
+    req->is_complete = true;
+    return true;
+}
+
+int
+file_handle_wait_any_aio(
+    io_request_t    **reqs,
+    int             n_reqs
+)
+{
+    const struct aiocb  *list[n_reqs > 0 ? n_reqs : 1];
+    
+    if ( n_reqs <= 0 ) return -1;
+    while ( true ) {
+        int         i;
+        
+        for ( i = 0; i < n_reqs; i++ ) {
+            if ( file_handle_poll_aio(reqs[i]) ) return i;
+            list[i] = &reqs[i]->aiocb;
+        }
+        aio_suspend(list, n_reqs, NULL);
+    }
+}
+
+bool
+file_handle_wait_all_aio(
+    io_request_t    **reqs,
+    int             n_reqs
+)
+{
+    return io_request_wait_all_with(file_handle_wait_any_aio, reqs, n_reqs);
+}
+
+static file_handle_callbacks file_handle_callbacks_aio = {
+        file_handle_open_fd,
+        file_handle_stat_fd,
+        file_handle_seek_fd,
+        file_handle_tell_fd,
+        file_handle_read_fd,
+        file_handle_write_fd,
+        file_handle_pread_fd,
+        file_handle_pwrite_fd,
+        file_handle_close_fd,
+        file_handle_fileno_fd,
+        file_handle_clone_fd,
+        file_handle_hint_fd,
+        NULL,
+        file_handle_submit_read_aio,
+        file_handle_submit_write_aio,
+        file_handle_poll_aio,
+        file_handle_wait_any_aio,
+        file_handle_wait_all_aio
+    };
+
+//
+
+/*
+ * The worker-thread pool is started by the first submission and lives until
+ * the program exits; completions are signalled on a single condition.  Its
+ * size is the -D threads=# tunable.
+ */
+static struct {
+    pthread_mutex_t         lock;
+    pthread_cond_t          work, done;
+    io_request_t            *head, *tail;
+    int                     n_threads, n_threads_wanted;
+} io_pool = {
+        PTHREAD_MUTEX_INITIALIZER,
+        PTHREAD_COND_INITIALIZER,
+        PTHREAD_COND_INITIALIZER,
+        NULL, NULL,
+        0, IO_POOL_DEFAULT_THREADS
+    };
+
+bool
+file_handle_option_pool(
+    const char      *key,
+    const char      *value
+)
+{
+    char            *eos = NULL;
+    long            v;
+    
+    if ( strcasecmp(key, "threads") || ! value ) return false;
+    v = strtol(value, &eos, 0);
+    if ( (v < 1) || (v > IO_POOL_MAX_THREADS) || (eos == value) || *eos ) return false;
+    io_pool.n_threads_wanted = v;
+    return true;
+}
+
+static void*
+io_pool_worker(
+    void            *context
+)
+{
+    while ( true ) {
+        io_request_t    *req;
+        ssize_t         n;
+        
+        pthread_mutex_lock(&io_pool.lock);
+        while ( ! io_pool.head ) pthread_cond_wait(&io_pool.work, &io_pool.lock);
+        req = io_pool.head;
+        if ( ! (io_pool.head = req->next) ) io_pool.tail = NULL;
+        pthread_mutex_unlock(&io_pool.lock);
+        
+        do {
+            n = file_handle_xfer_fd(req);
+        } while ( ! io_request_advance(req, (n < 0) ? -errno : n) );
+        
+        pthread_mutex_lock(&io_pool.lock);
+        req->is_complete = true;
+        pthread_cond_broadcast(&io_pool.done);
+        pthread_mutex_unlock(&io_pool.lock);
+    }
+    return NULL;
+}
+
+static io_request_t*
+file_handle_submit_pool(
+    io_request_t    *req
+)
+{
+    if ( ! req ) return NULL;
+    pthread_mutex_lock(&io_pool.lock);
+    if ( io_pool.n_threads == 0 ) {
+        int         t, prc = 0;
+        
+        for ( t = 0; t < io_pool.n_threads_wanted; t++ ) {
+            pthread_t   thread;
+            
+            if ( (prc = pthread_create(&thread, NULL, io_pool_worker, NULL)) != 0 ) break;
+            pthread_detach(thread);
+            io_pool.n_threads++;
+        }
+        if ( io_pool.n_threads == 0 ) {
+            pthread_mutex_unlock(&io_pool.lock);
+            io_request_free(req);
+            errno = prc;
+            return NULL;
+        }
+    }
+    if ( io_pool.tail ) {
+        io_pool.tail->next = req;
+    } else {
+        io_pool.head = req;
+    }
+    io_pool.tail = req;
+    pthread_cond_signal(&io_pool.work);
+    pthread_mutex_unlock(&io_pool.lock);
+    return req;
+}
+
+io_request_t*
+file_handle_submit_read_pool(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return file_handle_submit_pool(io_request_alloc(fh, buffer, buffer_len, offset, false));
+}
+
+io_request_t*
+file_handle_submit_write_pool(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return file_handle_submit_pool(io_request_alloc(fh, buffer, buffer_len, offset, true));
+}
+
+bool
+file_handle_poll_pool(
+    io_request_t    *req
+)
+{
+    bool            is_complete;
+    
+    pthread_mutex_lock(&io_pool.lock);
+    is_complete = req->is_complete;
+    pthread_mutex_unlock(&io_pool.lock);
+    return is_complete;
+}
+
+int
+file_handle_wait_any_pool(
+    io_request_t    **reqs,
+    int             n_reqs
+)
+{
+    int             i = -1;
+    
+    if ( n_reqs <= 0 ) return -1;
+    pthread_mutex_lock(&io_pool.lock);
+    while ( true ) {
+        for ( i = 0; i < n_reqs; i++ ) if ( reqs[i]->is_complete ) break;
+        if ( i < n_reqs ) break;
+        pthread_cond_wait(&io_pool.done, &io_pool.lock);
+    }
+    pthread_mutex_unlock(&io_pool.lock);
+    return i;
+}
+
+bool
+file_handle_wait_all_pool(
+    io_request_t    **reqs,
+    int             n_reqs
+)
+{
+    return io_request_wait_all_with(file_handle_wait_any_pool, reqs, n_reqs);
+}
+
+static file_handle_callbacks file_handle_callbacks_pool = {
+        file_handle_open_fd,
+        file_handle_stat_fd,
+        file_handle_seek_fd,
+        file_handle_tell_fd,
+        file_handle_read_fd,
+        file_handle_write_fd,
+        file_handle_pread_fd,
+        file_handle_pwrite_fd,
+        file_handle_close_fd,
+        file_handle_fileno_fd,
+        file_handle_clone_fd,
+        file_handle_hint_fd,
+        file_handle_option_pool,
+        file_handle_submit_read_pool,
+        file_handle_submit_write_pool,
+        file_handle_poll_pool,
+        file_handle_wait_any_pool,
+        file_handle_wait_all_pool
+    };
+
+//
+
+/*
+ * The uring driver shares one ring (set up by the first submission) among
+ * all of its file handles; the request pointer is the user_data of its
+ * submissions.  Completions are reaped by poll and wait_any.  The ring size
+ * and kernel-side polling are the -D depth=# and -D sqpoll tunables.
+ */
+static uring_t uring_driver_ring = { -1 };
+
+static struct {
+    unsigned                entries;
+    bool                    sqpoll;
+} uring_driver_config = {
+        URING_DRIVER_ENTRIES,
+        false
     };
-static char *cli_options_str = "hi:o:1:2:3:xa:d:I";
 
+bool
+file_handle_option_uring(
+    const char      *key,
+    const char      *value
+)
+{
+    if ( ! strcasecmp(key, "depth") && value ) {
+        char        *eos = NULL;
+        long        v = strtol(value, &eos, 0);
+        
+        if ( (v < 1) || (v > URING_MAX_ENTRIES) || (eos == value) || *eos ) return false;
+        uring_driver_config.entries = v;
+        return true;
+    }
+    if ( ! strcasecmp(key, "sqpoll") ) return file_handle_option_bool(value, &uring_driver_config.sqpoll);
+    return false;
+}
+
+static bool
+uring_driver_queue(
+    io_request_t            *req
+)
+{
+    uring_t                 *R = &uring_driver_ring;
+    struct io_uring_sqe     *sqe;
+    size_t                  len = req->buffer_len - req->done;
+    
+    if ( len > IO_MAX_SINGLE_TRANSFER ) len = IO_MAX_SINGLE_TRANSFER;
+    while ( ! (sqe = uring_get_sqe(R)) ) {
+        //
+        // Without SQPOLL submitting empties the submission ring; with it
+        // the kernel thread drains the ring in its own time:
+        //
+        if ( uring_submit(R, 0) < 0 ) return false;
+        if ( R->sqpoll ) sched_yield();
+    }
+    uring_prep_rw(sqe, req->is_write ? IORING_OP_WRITE : IORING_OP_READ, req->fh->fd,
+            req->buffer + req->done, len, req->offset + req->done, -1, false, (unsigned long long)(uintptr_t)req);
+    return (uring_submit(R, 0) >= 0) ? true : false;
+}
+
+static void
+uring_driver_reap(void)
+{
+    struct io_uring_cqe     *cqe;
+    
+    while ( (cqe = uring_peek_cqe(&uring_driver_ring)) ) {
+        io_request_t        *req = (io_request_t*)(uintptr_t)cqe->user_data;
+        int                 res = cqe->res;
+        
+        uring_cqe_seen(&uring_driver_ring);
+        if ( ! io_request_advance(req, res) ) {
+            if ( uring_driver_queue(req) ) continue;
+            req->error = errno;
+        }
+        req->is_complete = true;
+    }
+}
+
+static io_request_t*
+file_handle_submit_uring(
+    io_request_t    *req
+)
+{
+    if ( ! req ) return NULL;
+    if ( (uring_driver_ring.fd < 0) && ! uring_init(&uring_driver_ring, uring_driver_config.entries, uring_driver_config.sqpoll) ) {
+        int         error = errno;
+        
+        io_request_free(req);
+        errno = error;
+        return NULL;
+    }
+    if ( ! uring_driver_queue(req) ) {
+        int         error = errno;
+        
+        io_request_free(req);
+        errno = error;
+        return NULL;
+    }
+    return req;
+}
+
+io_request_t*
+file_handle_submit_read_uring(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return file_handle_submit_uring(io_request_alloc(fh, buffer, buffer_len, offset, false));
+}
+
+io_request_t*
+file_handle_submit_write_uring(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return file_handle_submit_uring(io_request_alloc(fh, buffer, buffer_len, offset, true));
+}
+
+bool
+file_handle_poll_uring(
+    io_request_t    *req
+)
+{
+    if ( ! req->is_complete ) uring_driver_reap();
+    return req->is_complete;
+}
+
+int
+file_handle_wait_any_uring(
+    io_request_t    **reqs,
+    int             n_reqs
+)
+{
+    if ( n_reqs <= 0 ) return -1;
+    while ( true ) {
+        int         i;
+        
+        uring_driver_reap();
+        for ( i = 0; i < n_reqs; i++ ) if ( reqs[i]->is_complete ) return i;
+        if ( (uring_submit(&uring_driver_ring, 1) < 0) && (errno != EINTR) ) {
+            //
+            // Nothing can complete any more; fail the outstanding requests:
+            //
+            int     error = errno;
+            
+            for ( i = 0; i < n_reqs; i++ ) {
+                reqs[i]->error = error;
+                reqs[i]->is_complete = true;
+            }
+            return 0;
+        }
+    }
+}
+
+bool
+file_handle_wait_all_uring(
+    io_request_t    **reqs,
+    int             n_reqs
+)
+{
+    return io_request_wait_all_with(file_handle_wait_any_uring, reqs, n_reqs);
+}
+
+static file_handle_callbacks file_handle_callbacks_uring = {
+        file_handle_open_fd,
+        file_handle_stat_fd,
+        file_handle_seek_fd,
+        file_handle_tell_fd,
+        file_handle_read_fd,
+        file_handle_write_fd,
+        file_handle_pread_fd,
+        file_handle_pwrite_fd,
+        file_handle_close_fd,
+        file_handle_fileno_fd,
+        file_handle_clone_fd,
+        file_handle_hint_fd,
+        file_handle_option_uring,
+        file_handle_submit_read_uring,
+        file_handle_submit_write_uring,
+        file_handle_poll_uring,
+        file_handle_wait_any_uring,
+        file_handle_wait_all_uring
+    };
+
+//
+
+/*
+ * The lossy driver stores the file compressed to a fixed absolute accuracy,
+ * one j slab (n1 x n3 elements, contiguous in both the jki and jik layouts)
+ * at a time.  Written bytes are gathered per slab and each slab is encoded
+ * as soon as all of it has been written:  the values are quantized to
+ * multiples of the -D tolerance=<error> bound (so every value is within
+ * tolerance / 2 of the original), delta-coded along the slab, zigzagged and
+ * bit-packed in blocks of LOSSY_BLOCK_LEN with one width byte per block.
+ * (Values whose magnitude puts their ulp above the tolerance keep the
+ * double's own rounding error instead.)
+ * A slab that will not quantize (non-finite values, magnitudes beyond 2^62
+ * quanta, a zero tolerance) or does not shrink is stored raw.  Slabs are
+ * appended in the order they complete; a header and a slab index make the
+ * file readable, and reading decodes slabs into a cache of -D cache=#
+ * slabs.
+ *
+ * A bitmap per incomplete slab records which of its elements have been
+ * written, so writing a range twice cannot complete a slab early (an element
+ * only counts once all of its bytes have been written in one call).  A
+ * write to a slab already stored decodes it again and stores it anew.  Every
+ * incomplete slab is held in memory, and the memory budget caps how many
+ * there can be:  a write order that leaves more of them incomplete at once
+ * (ijk_map touches every slab in each of its passes) fails with ENOMEM
+ * rather than growing without bound.  The other algorithms complete slabs
+ * one at a time or batch by batch.
+ *
+ * The file is not in raw layout, so there is no fileno (nor hints or
+ * preallocation), and no positional i/o or cloning.
+ */
+#define LOSSY_MAGIC                 "SAPTLSY1"
+#define LOSSY_BLOCK_LEN             64
+#define LOSSY_DEFAULT_TOLERANCE     1e-10
+#define LOSSY_DEFAULT_CACHE_SLABS   4
+
+const char* memory_with_natural_unit(size_t bytes);
+
+typedef enum {
+    lossy_coding_zero = 0,
+    lossy_coding_raw,
+    lossy_coding_packed
+} lossy_coding_t;
+
+typedef struct {
+    char            magic[8];
+    uint64_t        slab_len, n_slabs;
+    double          tolerance;
+    uint64_t        index_offset;
+} lossy_header_t;
+
+typedef struct {
+    uint64_t        offset, length, coding;
+} lossy_index_t;
+
+typedef struct {
+    double          *data;
+    uint64_t        slab;
+    unsigned long   last_use;
+} lossy_cache_slot_t;
+
+typedef struct lossy_handle {
+    int                 fd;
+    bool                is_writer;
+    lossy_header_t      header;
+    lossy_index_t       *index;
+    off_t               position, end;
+    double              **pending;
+    uint64_t            **covered;
+    uint64_t            *filled;
+    uint64_t            n_pending, max_pending;
+    lossy_cache_slot_t  *cache;
+    int                 n_cache;
+    unsigned long       use_count;
+    unsigned char       *scratch;
+} lossy_handle_t;
+
+static struct {
+    unsigned long   dims[3];
+    size_t          mem_budget;
+    double          tolerance;
+    int             cache_slabs;
+} lossy_driver_config = {
+        { 0, 0, 0 },
+        (size_t)-1,
+        LOSSY_DEFAULT_TOLERANCE,
+        LOSSY_DEFAULT_CACHE_SLABS
+    };
+
+/*
+ * A written file's slab shape comes from main(), via the (n1, n2, n3)
+ * dimensions, before any file is opened.
+ */
+void
+lossy_driver_set_dims(
+    unsigned long   *n
+)
+{
+    memcpy(lossy_driver_config.dims, n, sizeof(lossy_driver_config.dims));
+}
+
+/*
+ * The incomplete slabs a written file holds in memory are limited to the
+ * driver's share of the memory budget, also set by main().
+ */
+void
+lossy_driver_set_budget(
+    size_t          mem_budget
+)
+{
+    lossy_driver_config.mem_budget = mem_budget;
+}
+
+bool
+file_handle_option_lossy(
+    const char      *key,
+    const char      *value
+)
+{
+    char            *eos = NULL;
+    
+    if ( ! value ) return false;
+    if ( ! strcasecmp(key, "tolerance") ) {
+        double      v = strtod(value, &eos);
+        
+        if ( ! (v >= 0.0) || ! isfinite(v) || (eos == value) || *eos ) return false;
+        lossy_driver_config.tolerance = v;
+        return true;
+    }
+    if ( ! strcasecmp(key, "cache") ) {
+        long        v = strtol(value, &eos, 0);
+        
+        if ( (v < 1) || (v > 1024) || (eos == value) || *eos ) return false;
+        lossy_driver_config.cache_slabs = v;
+        return true;
+    }
+    return false;
+}
+
+//
+
+/*
+ * Bit-packing into (and out of) little-endian 64-bit words; a value of w
+ * bits must have no bits set above them.
+ */
+typedef struct {
+    unsigned char   *p;
+    uint64_t        acc;
+    int             n;
+} lossy_bits_t;
+
+static inline void
+lossy_bits_put(
+    lossy_bits_t    *B,
+    uint64_t        v,
+    int             w
+)
+{
+    if ( w == 0 ) return;
+    B->acc |= v << B->n;
+    if ( B->n + w >= 64 ) {
+        memcpy(B->p, &B->acc, sizeof(B->acc));
+        B->p += sizeof(B->acc);
+        B->acc = B->n ? (v >> (64 - B->n)) : 0;
+        B->n += w - 64;
+    } else {
+        B->n += w;
+    }
+}
+
+static inline void
+lossy_bits_flush(
+    lossy_bits_t    *B
+)
+{
+    if ( B->n ) {
+        memcpy(B->p, &B->acc, sizeof(B->acc));
+        B->p += sizeof(B->acc);
+        B->acc = 0;
+        B->n = 0;
+    }
+}
+
+static inline uint64_t
+lossy_bits_get(
+    lossy_bits_t    *B,
+    int             w
+)
+{
+    uint64_t        v, next, mask = (w == 64) ? ~(uint64_t)0 : (((uint64_t)1 << w) - 1);
+    int             shift;
+    
+    if ( w == 0 ) return 0;
+    if ( B->n >= w ) {
+        v = B->acc & mask;
+        B->acc = (w == 64) ? 0 : (B->acc >> w);
+        B->n -= w;
+        return v;
+    }
+    memcpy(&next, B->p, sizeof(next));
+    B->p += sizeof(next);
+    v = (B->acc | (next << B->n)) & mask;
+    shift = w - B->n;
+    B->acc = (shift == 64) ? 0 : (next >> shift);
+    B->n = 64 - shift;
+    return v;
+}
+
+/*
+ * Worst-case encoded size of a slab of len values:  a width byte per block
+ * and 64 bits per value.
+ */
+static size_t
+lossy_encoded_max(
+    uint64_t        len
+)
+{
+    return (len + LOSSY_BLOCK_LEN - 1) / LOSSY_BLOCK_LEN + sizeof(uint64_t) * (len + 1);
+}
+
+/*
+ * Encode v[0..len) into out; returns the byte count, or 0 if the slab must
+ * be stored raw.
+ */
+static size_t
+lossy_encode(
+    const double    *v,
+    uint64_t        len,
+    double          tolerance,
+    unsigned char   *out
+)
+{
+    uint64_t        n_blocks = (len + LOSSY_BLOCK_LEN - 1) / LOSSY_BLOCK_LEN, b, i;
+    lossy_bits_t    B = { out + n_blocks, 0, 0 };
+    int64_t         prev = 0;
+    
+    if ( ! (tolerance > 0.0) ) return 0;
+    for ( b = 0; b < n_blocks; b++ ) {
+        uint64_t    zz[LOSSY_BLOCK_LEN], any = 0;
+        uint64_t    i0 = b * LOSSY_BLOCK_LEN, i_end = (i0 + LOSSY_BLOCK_LEN < len) ? i0 + LOSSY_BLOCK_LEN : len;
+        int         w;
+        
+        for ( i = i0; i < i_end; i++ ) {
+            double  q = nearbyint(v[i] / tolerance);
+            int64_t qi, d;
+            
+            if ( ! (fabs(q) < 0x1p62) ) return 0;
+            qi = (int64_t)q;
+            d = qi - prev;
+            prev = qi;
+            zz[i - i0] = ((uint64_t)d << 1) ^ (uint64_t)(d >> 63);
+            any |= zz[i - i0];
+        }
+        w = any ? 64 - __builtin_clzll(any) : 0;
+        out[b] = w;
+        for ( i = i0; i < i_end; i++ ) lossy_bits_put(&B, zz[i - i0], w);
+    }
+    lossy_bits_flush(&B);
+    return B.p - out;
+}
+
+static void
+lossy_decode(
+    const unsigned char *in,
+    uint64_t            len,
+    double              tolerance,
+    double              *v
+)
+{
+    uint64_t            n_blocks = (len + LOSSY_BLOCK_LEN - 1) / LOSSY_BLOCK_LEN, i;
+    lossy_bits_t        B = { (unsigned char*)in + n_blocks, 0, 0 };
+    int64_t             q = 0;
+    
+    for ( i = 0; i < len; i++ ) {
+        uint64_t        zz = lossy_bits_get(&B, in[i / LOSSY_BLOCK_LEN]);
+        
+        q += (int64_t)((zz >> 1) ^ -(zz & 1));
+        v[i] = q * tolerance;
+    }
+}
+
+//
+
+/*
+ * Decode a stored slab into data.
+ */
+static bool
+lossy_load_slab(
+    lossy_handle_t      *h,
+    uint64_t            slab,
+    double              *data
+)
+{
+    lossy_index_t       *I = &h->index[slab];
+    size_t              slab_bytes = sizeof(double) * h->header.slab_len;
+    
+    switch ( I->coding ) {
+        case lossy_coding_zero:
+            memset(data, 0, slab_bytes);
+            return true;
+        case lossy_coding_raw:
+            if ( (I->length == slab_bytes) && (pread(h->fd, data, slab_bytes, I->offset) == slab_bytes) ) return true;
+            break;
+        case lossy_coding_packed:
+            //
+            // The scratch buffer has a spare word so the unpacker can read
+            // whole words at the end:
+            //
+            if ( (I->length <= lossy_encoded_max(h->header.slab_len)) && (pread(h->fd, h->scratch, I->length, I->offset) == I->length) ) {
+                memset(h->scratch + I->length, 0, sizeof(uint64_t));
+                lossy_decode(h->scratch, h->header.slab_len, h->header.tolerance, data);
+                return true;
+            }
+            break;
+    }
+    errno = EIO;
+    return false;
+}
+
+static bool
+lossy_flush_slab(
+    lossy_handle_t  *h,
+    uint64_t        slab
+)
+{
+    size_t          slab_bytes = sizeof(double) * h->header.slab_len, n_bytes;
+    lossy_index_t   *I = &h->index[slab];
+    const void      *payload = h->scratch;
+    
+    if ( (n_bytes = lossy_encode(h->pending[slab], h->header.slab_len, h->header.tolerance, h->scratch)) && (n_bytes < slab_bytes) ) {
+        I->coding = lossy_coding_packed;
+    } else {
+        I->coding = lossy_coding_raw;
+        payload = h->pending[slab];
+        n_bytes = slab_bytes;
+    }
+    //
+    // A slab stored before is overwritten in place if the new encoding fits:
+    //
+    if ( ! I->length || (n_bytes > I->length) ) I->offset = h->end;
+    if ( pwrite(h->fd, payload, n_bytes, I->offset) != n_bytes ) {
+        if ( errno == 0 ) errno = EIO;
+        return false;
+    }
+    if ( I->offset == h->end ) h->end += n_bytes;
+    I->length = n_bytes;
+    free((void*)h->pending[slab]);
+    h->pending[slab] = NULL;
+    free((void*)h->covered[slab]);
+    h->covered[slab] = NULL;
+    h->filled[slab] = 0;
+    h->n_pending--;
+    return true;
+}
+
+/*
+ * Start holding a slab in memory, decoding it if it was stored before.
+ */
+static bool
+lossy_pending_slab(
+    lossy_handle_t  *h,
+    uint64_t        slab
+)
+{
+    uint64_t        slab_len = h->header.slab_len, n_words = (slab_len + 63) / 64;
+    
+    if ( h->n_pending >= h->max_pending ) {
+        fprintf(stderr, "ERROR:  lossy driver limited to %llu incomplete slab(s) by the memory budget; this write order does not stream\n",
+                (unsigned long long)h->max_pending);
+        errno = ENOMEM;
+        return false;
+    }
+    if ( ! (h->pending[slab] = (double*)calloc(slab_len, sizeof(double))) ) return false;
+    if ( ! (h->covered[slab] = (uint64_t*)calloc(n_words, sizeof(uint64_t))) ) {
+        free((void*)h->pending[slab]);
+        h->pending[slab] = NULL;
+        return false;
+    }
+    if ( h->index[slab].length ) {
+        //
+        // All of a stored slab is written, so it is stored again after each
+        // write to it.  If it cannot be decoded it is not held at all, so a
+        // later write cannot store zeros over it:
+        //
+        if ( ! lossy_load_slab(h, slab, h->pending[slab]) ) {
+            free((void*)h->pending[slab]);
+            h->pending[slab] = NULL;
+            free((void*)h->covered[slab]);
+            h->covered[slab] = NULL;
+            return false;
+        }
+        memset(h->covered[slab], 0xff, n_words * sizeof(uint64_t));
+        h->filled[slab] = slab_len;
+    }
+    h->n_pending++;
+    return true;
+}
+
+/*
+ * Mark the elements wholly inside bytes [lo, hi) of a slab as written;
+ * returns how many had not been before.
+ */
+static uint64_t
+lossy_cover(
+    uint64_t        *covered,
+    size_t          lo,
+    size_t          hi
+)
+{
+    uint64_t        e = (lo + sizeof(double) - 1) / sizeof(double), e_end = hi / sizeof(double), n_new = 0;
+    
+    while ( e < e_end ) {
+        uint64_t    w = e / 64, b = e % 64, n = (e_end - e < 64 - b) ? (e_end - e) : (64 - b);
+        uint64_t    mask = ((n == 64) ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1)) << b;
+        
+        n_new += __builtin_popcountll(mask & ~covered[w]);
+        covered[w] |= mask;
+        e += n;
+    }
+    return n_new;
+}
+
+static double*
+lossy_cached_slab(
+    lossy_handle_t      *h,
+    uint64_t            slab
+)
+{
+    lossy_cache_slot_t  *S = NULL;
+    size_t              slab_bytes = sizeof(double) * h->header.slab_len;
+    int                 c;
+    
+    for ( c = 0; c < h->n_cache; c++ ) {
+        if ( h->cache[c].data && (h->cache[c].slab == slab) ) {
+            h->cache[c].last_use = ++h->use_count;
+            return h->cache[c].data;
+        }
+        if ( ! S || ! h->cache[c].data || (S->data && (h->cache[c].last_use < S->last_use)) ) S = &h->cache[c];
+    }
+    if ( ! S->data && ! (S->data = (double*)malloc(slab_bytes)) ) return NULL;
+    S->slab = slab;
+    S->last_use = ++h->use_count;
+    if ( lossy_load_slab(h, slab, S->data) ) return S->data;
+    S->last_use = 0;
+    S->slab = UINT64_MAX;
+    return NULL;
+}
+
+//
+
+void file_handle_close_lossy(file_handle_t *fh);
+
+/*
+ * The header is written from a copy:  with the handle's header gcc cannot
+ * see past its first member and warns of an overread.
+ */
+static bool
+lossy_write_header(
+    lossy_handle_t  *h
+)
+{
+    lossy_header_t  header = h->header;
+    
+    return (pwrite(h->fd, &header, sizeof(header), 0) == sizeof(header)) ? true : false;
+}
+
+/*
+ * A written file is always created anew; a read file must match the
+ * dimensions, if they have been set.
+ */
+bool
+file_handle_open_lossy(
+    file_handle_t   *fh,
+    const char      *path,
+    bool            read_only,
+    bool            should_create,
+    bool            should_trunc
+)
+{
+    lossy_handle_t  *h;
+    unsigned long   *n = lossy_driver_config.dims;
+    size_t          index_bytes;
+    int             error = EINVAL;
+    
+    fh->lossy = NULL;
+    if ( ! read_only && ! n[0] ) {
+        errno = EINVAL;
+        return false;
+    }
+    if ( ! (h = (lossy_handle_t*)calloc(1, sizeof(lossy_handle_t))) ) return false;
+    fh->lossy = h;
+    h->is_writer = ! read_only;
+    if ( (h->fd = open(path, read_only ? O_RDONLY : (O_RDWR | O_CREAT | O_TRUNC), 0666)) < 0 ) {
+        error = errno;
+        goto failed;
+    }
+    if ( read_only ) {
+        if ( (pread(h->fd, &h->header, sizeof(h->header), 0) != sizeof(h->header)) || memcmp(h->header.magic, LOSSY_MAGIC, sizeof(h->header.magic)) ) goto failed;
+        if ( ! h->header.slab_len || ! h->header.index_offset ) goto failed;
+        if ( n[0] && ((h->header.slab_len != n[0] * n[2]) || (h->header.n_slabs != n[1])) ) goto failed;
+    } else {
+        memcpy(h->header.magic, LOSSY_MAGIC, sizeof(h->header.magic));
+        h->header.slab_len = n[0] * n[2];
+        h->header.n_slabs = n[1];
+        h->header.tolerance = lossy_driver_config.tolerance;
+        h->end = sizeof(h->header);
+        if ( ! lossy_write_header(h) ) {
+            error = errno;
+            goto failed;
+        }
+    }
+    index_bytes = sizeof(lossy_index_t) * h->header.n_slabs;
+    error = ENOMEM;
+    if ( ! (h->index = (lossy_index_t*)calloc(h->header.n_slabs, sizeof(lossy_index_t))) ) goto failed;
+    if ( ! (h->scratch = (unsigned char*)malloc(lossy_encoded_max(h->header.slab_len) + sizeof(uint64_t))) ) goto failed;
+    if ( read_only ) {
+        h->n_cache = lossy_driver_config.cache_slabs;
+        if ( ! (h->cache = (lossy_cache_slot_t*)calloc(h->n_cache, sizeof(lossy_cache_slot_t))) ) goto failed;
+        if ( pread(h->fd, h->index, index_bytes, h->header.index_offset) != index_bytes ) {
+            error = EINVAL;
+            goto failed;
+        }
+    } else {
+        size_t      slab_bytes = sizeof(double) * h->header.slab_len + sizeof(uint64_t) * ((h->header.slab_len + 63) / 64);
+        
+        if ( ! (h->pending = (double**)calloc(h->header.n_slabs, sizeof(double*))) ) goto failed;
+        if ( ! (h->covered = (uint64_t**)calloc(h->header.n_slabs, sizeof(uint64_t*))) ) goto failed;
+        if ( ! (h->filled = (uint64_t*)calloc(h->header.n_slabs, sizeof(uint64_t))) ) goto failed;
+        h->max_pending = lossy_driver_config.mem_budget / slab_bytes;
+    }
+    return true;
+    
+failed:
+    h->is_writer = false;
+    file_handle_close_lossy(fh);
+    errno = error;
+    return false;
+}
+
+bool
+file_handle_stat_lossy(
+    file_handle_t   *fh,
+    struct stat     *finfo
+)
+{
+    lossy_handle_t  *h = fh->lossy;
+    
+    if ( fstat(h->fd, finfo) != 0 ) return false;
+    finfo->st_size = sizeof(double) * h->header.slab_len * h->header.n_slabs;
+    return true;
+}
+
+off_t
+file_handle_seek_lossy(
+    file_handle_t   *fh,
+    off_t           offset
+)
+{
+    if ( offset < 0 ) {
+        errno = EINVAL;
+        return -1;
+    }
+    return (fh->lossy->position = offset);
+}
+
+off_t
+file_handle_tell_lossy(
+    file_handle_t   *fh
+)
+{
+    return fh->lossy->position;
+}
+
+ssize_t
+file_handle_read_lossy(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len
+)
+{
+    lossy_handle_t  *h = fh->lossy;
+    size_t          slab_bytes = sizeof(double) * h->header.slab_len, total = 0;
+    off_t           file_len = slab_bytes * h->header.n_slabs;
+    
+    if ( h->is_writer ) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    if ( h->position >= file_len ) return 0;
+    if ( buffer_len > file_len - h->position ) buffer_len = file_len - h->position;
+    while ( total < buffer_len ) {
+        uint64_t    slab = h->position / slab_bytes;
+        size_t      within = h->position % slab_bytes, piece = slab_bytes - within;
+        double      *data = lossy_cached_slab(h, slab);
+        
+        if ( ! data ) return total ? total : -1;
+        if ( piece > buffer_len - total ) piece = buffer_len - total;
+        memcpy((char*)buffer + total, (char*)data + within, piece);
+        total += piece;
+        h->position += piece;
+    }
+    return total;
+}
+
+ssize_t
+file_handle_write_lossy(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len
+)
+{
+    lossy_handle_t  *h = fh->lossy;
+    size_t          slab_bytes = sizeof(double) * h->header.slab_len, total = 0;
+    
+    if ( ! h->is_writer ) {
+        errno = EBADF;
+        return -1;
+    }
+    if ( h->position + buffer_len > slab_bytes * h->header.n_slabs ) {
+        errno = EFBIG;
+        return -1;
+    }
+    while ( total < buffer_len ) {
+        uint64_t    slab = h->position / slab_bytes;
+        size_t      within = h->position % slab_bytes, piece = slab_bytes - within;
+        
+        if ( ! h->pending[slab] && ! lossy_pending_slab(h, slab) ) return total ? total : -1;
+        if ( piece > buffer_len - total ) piece = buffer_len - total;
+        memcpy((char*)h->pending[slab] + within, (char*)buffer + total, piece);
+        total += piece;
+        h->position += piece;
+        h->filled[slab] += lossy_cover(h->covered[slab], within, within + piece);
+        if ( (h->filled[slab] >= h->header.slab_len) && ! lossy_flush_slab(h, slab) ) return -1;
+    }
+    return total;
+}
+
+/*
+ * Closing a written file encodes any incomplete slabs (unwritten parts are
+ * zero) and writes the index, then the header that points to it.
+ */
+void
+file_handle_close_lossy(
+    file_handle_t   *fh
+)
+{
+    lossy_handle_t  *h = fh->lossy;
+    uint64_t        slab;
+    int             c;
+    
+    if ( ! h ) return;
+    if ( h->is_writer ) {
+        bool        ok = true;
+        off_t       logical = sizeof(double) * h->header.slab_len * h->header.n_slabs;
+        size_t      index_bytes = sizeof(lossy_index_t) * h->header.n_slabs;
+        
+        for ( slab = 0; ok && (slab < h->header.n_slabs); slab++ ) {
+            if ( h->pending[slab] ) ok = lossy_flush_slab(h, slab);
+        }
+        h->header.index_offset = h->end;
+        if ( ! ok || (pwrite(h->fd, h->index, index_bytes, h->end) != index_bytes) || ! lossy_write_header(h) ) {
+            fprintf(stderr, "ERROR:  unable to complete lossy file (errno = %d)\n", errno);
+            exit(errno ? errno : EIO);
+        }
+        h->end += index_bytes;
+        printf("INFO:  lossy driver stored %s", memory_with_natural_unit(logical));
+        printf(" in %s (%.2fx, tolerance %g)\n", memory_with_natural_unit(h->end), (double)logical / h->end, h->header.tolerance);
+    }
+    if ( h->fd >= 0 ) close(h->fd);
+    if ( h->pending ) {
+        for ( slab = 0; slab < h->header.n_slabs; slab++ ) free((void*)h->pending[slab]);
+        free((void*)h->pending);
+    }
+    if ( h->covered ) {
+        for ( slab = 0; slab < h->header.n_slabs; slab++ ) free((void*)h->covered[slab]);
+        free((void*)h->covered);
+    }
+    if ( h->cache ) {
+        for ( c = 0; c < h->n_cache; c++ ) free((void*)h->cache[c].data);
+        free((void*)h->cache);
+    }
+    free((void*)h->filled);
+    free((void*)h->index);
+    free((void*)h->scratch);
+    free((void*)h);
+    fh->lossy = NULL;
+}
+
+static ssize_t
+file_handle_xfer_lossy(
+    io_request_t    *req
+)
+{
+    if ( file_handle_seek_lossy(req->fh, req->offset + req->done) < 0 ) return -1;
+    if ( req->is_write ) return file_handle_write_lossy(req->fh, req->buffer + req->done, req->buffer_len - req->done);
+    return file_handle_read_lossy(req->fh, req->buffer + req->done, req->buffer_len - req->done);
+}
+
+io_request_t*
+file_handle_submit_read_lossy(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return io_request_run_sync(io_request_alloc(fh, buffer, buffer_len, offset, false), file_handle_xfer_lossy);
+}
+
+io_request_t*
+file_handle_submit_write_lossy(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return io_request_run_sync(io_request_alloc(fh, buffer, buffer_len, offset, true), file_handle_xfer_lossy);
+}
+
+static file_handle_callbacks file_handle_callbacks_lossy = {
+        file_handle_open_lossy,
+        file_handle_stat_lossy,
+        file_handle_seek_lossy,
+        file_handle_tell_lossy,
+        file_handle_read_lossy,
+        file_handle_write_lossy,
+        NULL,
+        NULL,
+        file_handle_close_lossy,
+        NULL,
+        NULL,
+        NULL,
+        file_handle_option_lossy,
+        file_handle_submit_read_lossy,
+        file_handle_submit_write_lossy,
+        io_request_poll_sync,
+        io_request_wait_any_sync,
+        io_request_wait_all_sync
+    };
+
+//
+
+#ifdef HAVE_HDF5
+/*
+ * The hdf5 driver (output only) writes the jik-ordered result as an
+ * n2 x n1 x n3 dataset of doubles named "jik" in an HDF5 file.  The flat
+ * output is that dataset in row-major order, so a write at a byte offset
+ * covers a run of elements which is written as at most five hyperslabs
+ * (a partial row, partial j slab, whole j slabs, ...).  Chunks are one or
+ * more whole j slabs of about -D chunk=<size> bytes or, when a slab is
+ * larger than that, one slab split along k; the chunk cache (-D cache=<size>)
+ * is grown to hold at least one chunk per k so a partially-written slab is
+ * never evicted and rewritten.  -D deflate=<1-9> adds the shuffle and
+ * deflate filters.  The serial HDF5 library is not thread-safe, so there is
+ * no positional i/o or cloning and parallel transfers fall back to serial.
+ */
+#define HDF5_DATASET_NAME           "jik"
+#define HDF5_DEFAULT_CHUNK_BYTES    ((size_t)1024 * 1024)
+#define HDF5_DEFAULT_CACHE_BYTES    ((size_t)16 * 1024 * 1024)
+
+typedef struct hdf5_handle {
+    hid_t           file, dataset, filespace;
+    hsize_t         dims[3];
+    off_t           position;
+} hdf5_handle_t;
+
+static struct {
+    hsize_t         dims[3];
+    size_t          chunk_bytes, cache_bytes;
+    int             deflate;
+} hdf5_driver_config = {
+        { 0, 0, 0 },
+        HDF5_DEFAULT_CHUNK_BYTES,
+        HDF5_DEFAULT_CACHE_BYTES,
+        0
+    };
+
+/*
+ * The dataset shape is fixed at creation, so main() passes the (n1, n2, n3)
+ * dimensions in before the output file is opened.
+ */
+void
+hdf5_driver_set_dims(
+    unsigned long   *n
+)
+{
+    hdf5_driver_config.dims[0] = n[1];
+    hdf5_driver_config.dims[1] = n[0];
+    hdf5_driver_config.dims[2] = n[2];
+}
+
+bool
+file_handle_option_hdf5(
+    const char      *key,
+    const char      *value
+)
+{
+    if ( ! strcasecmp(key, "chunk") ) return (value && string_to_memory_size(value, &hdf5_driver_config.chunk_bytes) && hdf5_driver_config.chunk_bytes) ? true : false;
+    if ( ! strcasecmp(key, "cache") ) return (value && string_to_memory_size(value, &hdf5_driver_config.cache_bytes)) ? true : false;
+    if ( ! strcasecmp(key, "deflate") && value ) {
+        char        *eos = NULL;
+        long        v = strtol(value, &eos, 0);
+        
+        if ( (v < 0) || (v > 9) || (eos == value) || *eos ) return false;
+        hdf5_driver_config.deflate = v;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Smallest prime >= n, for the chunk cache's hash table size.
+ */
+static size_t
+hdf5_next_prime(
+    size_t          n
+)
+{
+    size_t          d;
+    
+    if ( n <= 2 ) return 2;
+    if ( ! (n & 1) ) n++;
+    for ( d = 3; d * d <= n; d += 2 ) {
+        if ( (n % d) == 0 ) {
+            n += 2;
+            d = 1;
+        }
+    }
+    return n;
+}
+
+static hid_t
+hdf5_dataset_access_plist(
+    const hsize_t   *dims,
+    const hsize_t   *chunk
+)
+{
+    hid_t           dapl = H5Pcreate(H5P_DATASET_ACCESS);
+    size_t          chunk_bytes = sizeof(double) * chunk[0] * chunk[1] * chunk[2];
+    size_t          row_bytes = chunk_bytes * ((dims[2] + chunk[2] - 1) / chunk[2]);
+    size_t          cache_bytes = hdf5_driver_config.cache_bytes;
+    
+    if ( cache_bytes < row_bytes ) cache_bytes = row_bytes;
+    if ( dapl >= 0 ) H5Pset_chunk_cache(dapl, hdf5_next_prime(100 * (cache_bytes / chunk_bytes + 1)), cache_bytes, 1.0);
+    return dapl;
+}
+
+static bool
+hdf5_create_dataset(
+    hdf5_handle_t   *h
+)
+{
+    size_t          slab_bytes = sizeof(double) * h->dims[1] * h->dims[2];
+    size_t          target = hdf5_driver_config.chunk_bytes;
+    hsize_t         chunk[3] = { 1, h->dims[1], h->dims[2] };
+    hid_t           dcpl, dapl;
+    
+    if ( slab_bytes <= target ) {
+        chunk[0] = target / slab_bytes;
+        if ( chunk[0] > h->dims[0] ) chunk[0] = h->dims[0];
+    } else {
+        hsize_t     n_k;
+        
+        //
+        // Even out the chunks along k so the last one is not mostly empty:
+        //
+        chunk[2] = target / (sizeof(double) * h->dims[1]);
+        if ( chunk[2] < 1 ) chunk[2] = 1;
+        n_k = (h->dims[2] + chunk[2] - 1) / chunk[2];
+        chunk[2] = (h->dims[2] + n_k - 1) / n_k;
+    }
+    if ( (dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0 ) return false;
+    H5Pset_chunk(dcpl, 3, chunk);
+    H5Pset_fill_time(dcpl, H5D_FILL_TIME_NEVER);
+    if ( hdf5_driver_config.deflate > 0 ) {
+        H5Pset_shuffle(dcpl);
+        H5Pset_deflate(dcpl, hdf5_driver_config.deflate);
+    }
+    dapl = hdf5_dataset_access_plist(h->dims, chunk);
+    h->dataset = H5Dcreate2(h->file, HDF5_DATASET_NAME, H5T_NATIVE_DOUBLE, h->filespace, H5P_DEFAULT, dcpl, dapl);
+    H5Pclose(dcpl);
+    if ( dapl >= 0 ) H5Pclose(dapl);
+    return (h->dataset >= 0) ? true : false;
+}
+
+/*
+ * Reopen the dataset of an existing file; its shape must match.
+ */
+static bool
+hdf5_open_dataset(
+    hdf5_handle_t   *h
+)
+{
+    hid_t           dcpl, space, dapl = -1;
+    hsize_t         chunk[3], dims[3];
+    
+    if ( (h->dataset = H5Dopen2(h->file, HDF5_DATASET_NAME, H5P_DEFAULT)) < 0 ) return false;
+    space = H5Dget_space(h->dataset);
+    if ( (space < 0) || (H5Sget_simple_extent_ndims(space) != 3) || (H5Sget_simple_extent_dims(space, dims, NULL) < 0) ||
+         (dims[0] != h->dims[0]) || (dims[1] != h->dims[1]) || (dims[2] != h->dims[2]) )
+    {
+        if ( space >= 0 ) H5Sclose(space);
+        errno = EINVAL;
+        return false;
+    }
+    H5Sclose(space);
+    
+    //
+    // The chunk cache is a property of the open dataset, so reopen it with
+    // one sized for its chunks:
+    //
+    if ( (dcpl = H5Dget_create_plist(h->dataset)) >= 0 ) {
+        if ( H5Pget_chunk(dcpl, 3, chunk) == 3 ) dapl = hdf5_dataset_access_plist(h->dims, chunk);
+        H5Pclose(dcpl);
+    }
+    if ( dapl >= 0 ) {
+        H5Dclose(h->dataset);
+        h->dataset = H5Dopen2(h->file, HDF5_DATASET_NAME, dapl);
+        H5Pclose(dapl);
+    }
+    return (h->dataset >= 0) ? true : false;
+}
+
+void file_handle_close_hdf5(file_handle_t *fh);
+
+/*
+ * Creating an existing file fails with EEXIST, as for the other drivers;
+ * opening one that is not an HDF5 file replaces it.
+ */
+bool
+file_handle_open_hdf5(
+    file_handle_t   *fh,
+    const char      *path,
+    bool            read_only,
+    bool            should_create,
+    bool            should_trunc
+)
+{
+    hdf5_handle_t   *h;
+    bool            is_new = true;
+    
+    fh->hdf5 = NULL;
+    if ( read_only ) {
+        errno = ENOTSUP;
+        return false;
+    }
+    if ( ! hdf5_driver_config.dims[0] ) {
+        errno = EINVAL;
+        return false;
+    }
+    if ( access(path, F_OK) == 0 ) {
+        if ( should_create ) {
+            errno = EEXIST;
+            return false;
+        }
+        if ( ! should_trunc && (H5Fis_hdf5(path) > 0) ) is_new = false;
+    }
+    if ( ! (h = (hdf5_handle_t*)calloc(1, sizeof(hdf5_handle_t))) ) return false;
+    h->file = h->dataset = h->filespace = -1;
+    memcpy(h->dims, hdf5_driver_config.dims, sizeof(h->dims));
+    fh->hdf5 = h;
+    
+    //
+    // Failures are reported by the caller, not on the HDF5 error stack:
+    //
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+    if ( is_new ) {
+        h->file = H5Fcreate(path, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    } else {
+        h->file = H5Fopen(path, H5F_ACC_RDWR, H5P_DEFAULT);
+    }
+    errno = EIO;
+    if ( (h->file < 0) || ((h->filespace = H5Screate_simple(3, h->dims, NULL)) < 0) ||
+         ! (is_new ? hdf5_create_dataset(h) : hdf5_open_dataset(h)) )
+    {
+        int         error = errno;
+        
+        file_handle_close_hdf5(fh);
+        errno = error;
+        return false;
+    }
+    return true;
+}
+
+bool
+file_handle_stat_hdf5(
+    file_handle_t   *fh,
+    struct stat     *finfo
+)
+{
+    hdf5_handle_t   *h = fh->hdf5;
+    
+    memset(finfo, 0, sizeof(*finfo));
+    finfo->st_mode = S_IFREG | 0644;
+    finfo->st_size = sizeof(double) * h->dims[0] * h->dims[1] * h->dims[2];
+    return true;
+}
+
+off_t
+file_handle_seek_hdf5(
+    file_handle_t   *fh,
+    off_t           offset
+)
+{
+    if ( offset < 0 ) {
+        errno = EINVAL;
+        return -1;
+    }
+    return (fh->hdf5->position = offset);
+}
+
+off_t
+file_handle_tell_hdf5(
+    file_handle_t   *fh
+)
+{
+    return fh->hdf5->position;
+}
+
+ssize_t
+file_handle_read_hdf5(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len
+)
+{
+    errno = ENOTSUP;
+    return -1;
+}
+
+/*
+ * Write the whole elements of buffer at the file position:  the run of
+ * elements is cut into hyperslabs at row and slab boundaries.  A trailing
+ * partial element is left for the next write (a short write).
+ */
+ssize_t
+file_handle_write_hdf5(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len
+)
+{
+    hdf5_handle_t   *h = fh->hdf5;
+    hsize_t         row = h->dims[2], slab = h->dims[1] * h->dims[2];
+    hsize_t         e = h->position / sizeof(double), e_end = e + buffer_len / sizeof(double);
+    const double    *src = (const double*)buffer;
+    
+    if ( (h->position % sizeof(double)) || (e == e_end) ) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ( e_end > h->dims[0] * slab ) {
+        errno = EFBIG;
+        return -1;
+    }
+    while ( e < e_end ) {
+        hsize_t     start[3] = { e / slab, (e / row) % h->dims[1], e % row };
+        hsize_t     count[3] = { 1, 1, 1 };
+        hsize_t     n;
+        hid_t       memspace;
+        herr_t      rc;
+        
+        if ( start[2] || (e_end - e < row) ) {
+            count[2] = row - start[2];
+            if ( count[2] > e_end - e ) count[2] = e_end - e;
+        } else if ( start[1] || (e_end - e < slab) ) {
+            count[1] = h->dims[1] - start[1];
+            if ( count[1] > (e_end - e) / row ) count[1] = (e_end - e) / row;
+            count[2] = row;
+        } else {
+            count[0] = (e_end - e) / slab;
+            count[1] = h->dims[1];
+            count[2] = row;
+        }
+        n = count[0] * count[1] * count[2];
+        if ( (memspace = H5Screate_simple(1, &n, NULL)) < 0 ) {
+            errno = EIO;
+            return -1;
+        }
+        rc = H5Sselect_hyperslab(h->filespace, H5S_SELECT_SET, start, NULL, count, NULL);
+        if ( rc >= 0 ) rc = H5Dwrite(h->dataset, H5T_NATIVE_DOUBLE, memspace, h->filespace, H5P_DEFAULT, src);
+        H5Sclose(memspace);
+        if ( rc < 0 ) {
+            errno = EIO;
+            return -1;
+        }
+        src += n;
+        e += n;
+    }
+    buffer_len = (char*)src - (char*)buffer;
+    h->position += buffer_len;
+    return buffer_len;
+}
+
+void
+file_handle_close_hdf5(
+    file_handle_t   *fh
+)
+{
+    hdf5_handle_t   *h = fh->hdf5;
+    
+    if ( h ) {
+        if ( h->dataset >= 0 ) H5Dclose(h->dataset);
+        if ( h->filespace >= 0 ) H5Sclose(h->filespace);
+        if ( h->file >= 0 ) H5Fclose(h->file);
+        free((void*)h);
+        fh->hdf5 = NULL;
+    }
+}
+
+static ssize_t
+file_handle_xfer_hdf5(
+    io_request_t    *req
+)
+{
+    if ( ! req->is_write ) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    if ( file_handle_seek_hdf5(req->fh, req->offset + req->done) < 0 ) return -1;
+    return file_handle_write_hdf5(req->fh, req->buffer + req->done, req->buffer_len - req->done);
+}
+
+io_request_t*
+file_handle_submit_read_hdf5(
+    file_handle_t   *fh,
+    void            *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return io_request_run_sync(io_request_alloc(fh, buffer, buffer_len, offset, false), file_handle_xfer_hdf5);
+}
+
+io_request_t*
+file_handle_submit_write_hdf5(
+    file_handle_t   *fh,
+    const void      *buffer,
+    size_t          buffer_len,
+    off_t           offset
+)
+{
+    return io_request_run_sync(io_request_alloc(fh, buffer, buffer_len, offset, true), file_handle_xfer_hdf5);
+}
+
+static file_handle_callbacks file_handle_callbacks_hdf5 = {
+        file_handle_open_hdf5,
+        file_handle_stat_hdf5,
+        file_handle_seek_hdf5,
+        file_handle_tell_hdf5,
+        file_handle_read_hdf5,
+        file_handle_write_hdf5,
+        NULL,
+        NULL,
+        file_handle_close_hdf5,
+        NULL,
+        NULL,
+        NULL,
+        file_handle_option_hdf5,
+        file_handle_submit_read_hdf5,
+        file_handle_submit_write_hdf5,
+        io_request_poll_sync,
+        io_request_wait_any_sync,
+        io_request_wait_all_sync
+    };
+#endif /* HAVE_HDF5 */
+
+//
+
+typedef enum {
+    io_driver_invalid = -1,
+    io_driver_fd = 0,
+    io_driver_stream,
+    io_driver_aio,
+    io_driver_pool,
+    io_driver_uring,
+    io_driver_lossy,
+#ifdef HAVE_HDF5
+    io_driver_hdf5,
+#endif
+    io_driver_max
+} io_driver_t;
+
+static char const* io_driver_names[] = {
+        "fd",
+        "stream",
+        "aio",
+        "pool",
+        "uring",
+        "lossy",
+#ifdef HAVE_HDF5
+        "hdf5",
+#endif
+        NULL
+    };
+
+static file_handle_callbacks* io_driver_callbacks[] = {
+        &file_handle_callbacks_fd,
+        &file_handle_callbacks_stream,
+        &file_handle_callbacks_aio,
+        &file_handle_callbacks_pool,
+        &file_handle_callbacks_uring,
+        &file_handle_callbacks_lossy,
+#ifdef HAVE_HDF5
+        &file_handle_callbacks_hdf5,
+#endif
+        NULL
+    };
+
+io_driver_t
+string_to_io_driver(
+    const char  *s
+)
+{
+    int         d = 0;
+    
+    while ( io_driver_names[d] ) {
+        if ( strcasecmp(io_driver_names[d], s) == 0 ) return d;
+        d++;
+    }
+    return io_driver_invalid;
+}
+
+//
+
+/*
+ * Options without a short form use codes beyond the range of char:
+ */
+enum {
+    cli_option_transfer_chunk = 0x100,
+    cli_option_transfer_threads,
+    cli_option_tenants,
+    cli_option_tenant,
+    cli_option_progress,
+    cli_option_throughput_log,
+    cli_option_repeat,
+    cli_option_baseline_dir,
+    cli_option_save_baseline,
+    cli_option_compare_baseline,
+    cli_option_regression_threshold,
+    cli_option_significance,
+    cli_option_threads,
+    cli_option_scaling,
+    cli_option_transpose_kernel,
+    cli_option_calibrate,
+    cli_option_prefetch_distance,
+    cli_option_no_fast_path,
+    cli_option_fast_path,
+    cli_option_uring_depth,
+    cli_option_uring_sqpoll,
+    cli_option_async_depth,
+    cli_option_preallocate,
+    cli_option_io_hints,
+    cli_option_input_driver,
+    cli_option_output_driver
+};
+
+static struct option cli_options[] = {
+        { "help",       no_argument,       0, 'h' },
+        { "input",      required_argument, 0, 'i' },
+        { "output",     required_argument, 0, 'o' },
+        { "n1",         required_argument, 0, '1' },
+        { "n2",         required_argument, 0, '2' },
+        { "n3",         required_argument, 0, '3' },
+        { "exact-dims", no_argument,       0, 'x' },
+        { "algorithm",  required_argument, 0, 'a' },
+        { "io-driver",  required_argument, 0, 'd' },
+        { "driver-opt", required_argument, 0, 'D' },
+        { "input-driver", required_argument, 0, cli_option_input_driver },
+        { "output-driver", required_argument, 0, cli_option_output_driver },
+        { "init-input", no_argument,       0, 'I' },
+        { "memory-budget", required_argument, 0, 'm' },
+        { "reorder-window", required_argument, 0, 'w' },
+        { "read-only",  no_argument,       0, 'R' },
+        { "write-only", no_argument,       0, 'W' },
+        { "accounting", no_argument,       0, 'A' },
+        { "transfer-chunk", required_argument, 0, cli_option_transfer_chunk },
+        { "transfer-threads", required_argument, 0, cli_option_transfer_threads },
+        { "tenants",    required_argument, 0, cli_option_tenants },
+        { "tenant",     required_argument, 0, cli_option_tenant },
+        { "progress",   required_argument, 0, cli_option_progress },
+        { "throughput-log", required_argument, 0, cli_option_throughput_log },
+        { "repeat",     required_argument, 0, cli_option_repeat },
+        { "baseline-dir", required_argument, 0, cli_option_baseline_dir },
+        { "save-baseline", required_argument, 0, cli_option_save_baseline },
+        { "compare-baseline", required_argument, 0, cli_option_compare_baseline },
+        { "regression-threshold", required_argument, 0, cli_option_regression_threshold },
+        { "significance", required_argument, 0, cli_option_significance },
+        { "threads",    required_argument, 0, cli_option_threads },
+        { "scaling",    optional_argument, 0, cli_option_scaling },
+        { "transpose-kernel", required_argument, 0, cli_option_transpose_kernel },
+        { "calibrate",  optional_argument, 0, cli_option_calibrate },
+        { "prefetch-distance", required_argument, 0, cli_option_prefetch_distance },
+        { "no-fast-path", no_argument,     0, cli_option_no_fast_path },
+        { "fast-path",  no_argument,       0, cli_option_fast_path },
+        { "uring-depth", required_argument, 0, cli_option_uring_depth },
+        { "uring-sqpoll", no_argument,     0, cli_option_uring_sqpoll },
+        { "async-depth", required_argument, 0, cli_option_async_depth },
+        { "preallocate", no_argument,     0, cli_option_preallocate },
+        { "io-hints",   no_argument,       0, cli_option_io_hints },
+        { NULL, 0, 0, 0 }
+    };
+static char *cli_options_str = "hi:o:1:2:3:xa:d:D:Im:w:RWA";
+
+void
+usage(
+    const char  *exe
+)
+{
+    transpose_kernel_t  *K = transpose_kernels;
+    
+    printf(
+            "usage:\n\n"
+            "    %s {options}\n\n"
+            "  options:\n\n"
+            "    -h/--help                    show this information\n"
+            "    -1 #, --n1=#                 range of index i\n"
+            "    -2 #, --n2=#                 range of index j\n"
+            "    -3 #, --n3=#                 range of index k\n"
+            "    -i <filepath>,               read (or possibly init) this file\n"
+            "        --input=<filepath>         as the source\n"
+            "    -o <filepath>,               write this file as the destination\n"
+            "        --output=<filepath>\n"
+            "    -x, --exact-dims             file sizes must exactly match the\n"
+            "                                   n1/n2/n3 dimensions\n"
+            "    -a <algorithm>,              use this specific i/o algorithm\n"
+            "        --algorithm=<algorithm>    in the input init and file processing\n"
+            "    -d <driver>,                 use this specific i/o driver for all\n"
+            "        --driver=<driver>          file access\n"
+            "    --input-driver=<driver>      use this i/o driver for the input file\n"
+            "    --output-driver=<driver>     use this i/o driver for the output file\n"
+            "    -D <key>[=<value>],          set a tunable of the i/o driver(s) (may be\n"
+            "        --driver-opt=<key>[=<value>] repeated; see <driver> below)\n"
+            "    -I, --init-input             generate newly-initialized data in\n"
+            "                                   in the input file\n"
+            "    -m <size>|auto,              limit buffer allocations to this many\n"
+            "        --memory-budget=<size>     bytes (K/M/G/T suffixes allowed); the\n"
+            "                                   default (auto) uses the tightest of\n"
+            "                                   the cgroup limit, MemAvailable and\n"
+            "                                   the Slurm job's memory request\n"
+            "    -w <size>,                   collect up to this many bytes of pending\n"
+            "        --reorder-window=<size>    element reads+writes in the *_map\n"
+            "                                   algorithms, then issue them sorted by\n"
+            "                                   file offset with adjacent elements\n"
+            "                                   merged (default 0, disabled)\n"
+            "    -R, --read-only              perform only the algorithm's input file\n"
+            "                                   reads, discarding the data (no output\n"
+            "                                   file is needed)\n"
+            "    -W, --write-only             perform only the algorithm's output file\n"
+            "                                   writes, using synthetic data in place\n"
+            "                                   of the input file reads\n"
+            "    --progress=<seconds>         print progress, recent throughput and ETA\n"
+            "                                   at this interval (default 30, 0 to\n"
+            "                                   disable); SIGUSR1 prints the same\n"
+            "                                   statistics immediately\n"
+            "    --throughput-log=<filepath>  append a per-second throughput time\n"
+            "                                   series (elapsed s, bytes done, GiB/s)\n"
+            "                                   to this file\n"
+            "    --repeat=#                   run the file processing this many times\n"
+            "                                   and report the timing statistics\n"
+            "    --save-baseline=<name>       save the processing times as the named\n"
+            "                                   baseline for this configuration\n"
+            "    --compare-baseline=<name>    compare the processing times against the\n"
+            "                                   named baseline for this configuration\n"
+            "                                   and exit with status 3 on a regression\n"
+            "    --baseline-dir=<dir>         directory holding <name>.baseline files\n"
+            "                                   (default .)\n"
+            "    --regression-threshold=<%%>   slowdown of the mean that counts as a\n"
+            "                                   regression (default 5)\n"
+            "    --significance=<p>           one-sided Welch's t-test level the\n"
+            "                                   slowdown must also pass (default 0.05)\n"
+            "    -A, --accounting             report /proc/self/io and getrusage deltas\n"
+            "                                   and i/o amplification for each phase\n"
+            "    --transfer-chunk=<size>      split large reads and writes into\n"
+            "                                   chunks of this size (default 64M)\n"
+            "    --transfer-threads=#         issue the chunks of a large transfer\n"
+            "                                   concurrently from this many threads\n"
+            "                                   (each on its own clone of the file handle)\n"
+            "    --threads=#                  worker threads for matrix_parallel\n"
+            "                                   (default 1)\n"
+            "    --scaling[=numa]             run the processing with matrix_parallel at\n"
+            "                                   1, 2, 4, ... threads up to the CPU\n"
+            "                                   count and report speedup, efficiency\n"
+            "                                   and where throughput saturates; with\n"
+            "                                   numa, repeat pinned to each NUMA node\n"
+            "    --transpose-kernel=<kernel>  in-memory slab transpose used by the\n"
+            "                                   matrix algorithms (default scalar)\n"
+            "    --prefetch-distance=#        tiles ahead the tiled, simd and streaming\n"
+            "                                   kernels prefetch their source rows\n"
+            "                                   (default 1, 0 disables)\n"
+            "    --calibrate[=<size>]         measure STREAM copy/triad bandwidth over\n"
+            "                                   3 arrays of this size (default 64M)\n"
+            "                                   at startup and report the transpose\n"
+            "                                   kernel's bandwidth as a fraction of it\n"
+            "    --uring-depth=#              work items matrix_uring keeps in flight\n"
+            "                                   (default 4)\n"
+            "    --uring-sqpoll               have a kernel thread poll matrix_uring's\n"
+            "                                   submission queue (no submit syscalls)\n"
+            "    --async-depth=#              work items matrix_async keeps in flight\n"
+            "                                   (default 2)\n"
+            "    --preallocate                allocate the whole output file before\n"
+            "                                   processing (fallocate) so out-of-order\n"
+            "                                   writes do not fragment it\n"
+            "    --io-hints                   pass access-pattern hints to the kernel\n"
+            "                                   (posix_fadvise/readahead); matrix also\n"
+            "                                   reads ahead the next transfer and drops\n"
+            "                                   consumed input and written output from\n"
+            "                                   the page cache\n"
+            "    --no-fast-path               run the algorithm even when n1 or n3 is 1\n"
+            "                                   (the layouts are then identical and\n"
+            "                                   the output is otherwise produced by a\n"
+            "                                   reflink or copy_file_range); the default\n"
+            "                                   with --repeat, --scaling and baselines\n"
+            "    --fast-path                  use the reflink or copy_file_range even\n"
+            "                                   with --repeat, --scaling and baselines\n"
+            "    --tenants=#                  fork this many concurrent copies of the\n"
+            "                                   transform; tenant t writes\n"
+            "                                   <output>.t (and inits <input>.t) and\n"
+            "                                   per-tenant, aggregate and fairness\n"
+            "                                   figures are reported\n"
+            "    --tenant=<algorithm>[:<n1>,<n2>,<n3>]\n"
+            "                                 algorithm and optional shape for the\n"
+            "                                   next tenant; repeat for each tenant,\n"
+            "                                   cycled if --tenants is larger\n\n"
+            "  <algorithm>:\n"
+            "    jki_map         iterates in sequence j, k, i, reading from input\n"
+            "                    then writing to output (this is the default)\n" 
+            "    jik_map         iterates in sequence j, i, k, reading from input\n"
+            "                    then writing to output\n"
+            "    ijk_map         iterates in sequence i, j, k, reading from input\n"
+            "                    then writing to output\n"
+            "    vector_input    1xn1 chunks are read from input then mapped by\n"
+            "                    index iteration to the output (requires n3 words of\n"
+            "                    memory)\n"
+            "    vector_output   1xn3 chunks are mapped by index iteration from the\n"
+            "                    input then written to the output (requires n3 words\n"
+            "                    of memory)\n"
+            "    matrix          n1xn3 chunks are read from input then transposed\n"
+            "                    in memory and written en masse to the output\n"
+            "                    (requires 2 x n1 x n3 words of memory; as many\n"
+            "                    j slabs as the memory budget allows are moved\n"
+            "                    per transfer, and slabs too large for the budget\n"
+            "                    are split over k)\n"
+            "    matrix_parallel as matrix, but --threads workers each move their own\n"
+            "                    batches of slabs through their own clones of\n"
+            "                    the file handles (requires 2 x threads buffers\n"
+            "                    within the memory budget)\n"
+            "    matrix_uring    as matrix, but --uring-depth batches are kept in\n"
+            "                    flight through an io_uring with registered\n"
+            "                    buffers and files (requires 2 x depth buffers\n"
+            "                    within the memory budget; falls back to matrix\n"
+            "                    if io_uring is unavailable)\n"
+            "    matrix_async    as matrix, but --async-depth batches are kept in\n"
+            "                    flight through the driver's asynchronous\n"
+            "                    submit/wait interface (requires 2 x depth\n"
+            "                    buffers within the memory budget; only the aio,\n"
+            "                    pool and uring drivers actually overlap i/o)\n\n"
+            "  <driver>:\n"
+            "    fd              Unix file descriptor - open/lseek/read/write/close\n"
+            "                    (this is the default)\n"
+            "    stream          C file stream - fopen/fseeko/fread/fwrite/fclose\n"
+            "                    (-D buffer=<size> sets the stream buffer size,\n"
+            "                    -D mode=full|line|none the buffering mode)\n"
+            "    aio             as fd, with POSIX AIO (aio_read/aio_write/\n"
+            "                    aio_suspend) for asynchronous transfers\n"
+            "    pool            as fd, with a pool of worker threads doing\n"
+            "                    pread/pwrite for asynchronous transfers\n"
+            "                    (-D threads=# sets the pool size, default 4)\n"
+            "    uring           as fd, with a shared io_uring for asynchronous\n"
+            "                    transfers (-D depth=# sets the ring size,\n"
+            "                    default 256; -D sqpoll polls it from a kernel\n"
+            "                    thread)\n"
+            "    lossy           compressed to an absolute error bound, per j slab\n"
+            "                    (-D tolerance=<error> sets the bound, default\n"
+            "                    1e-10; -D cache=# the slabs kept decoded when\n"
+            "                    reading, default 4)\n"
+#ifdef HAVE_HDF5
+            "    hdf5            output only:  an n2 x n1 x n3 HDF5 dataset \"jik\"\n"
+            "                    chunked by j slabs (-D chunk=<size> sets the\n"
+            "                    chunk size, default 1 MiB; -D cache=<size> the\n"
+            "                    chunk cache, default 16 MiB; -D deflate=<1-9>\n"
+            "                    adds shuffle+deflate compression)\n"
+#endif
+            "\n"
+            "  <kernel>:\n",
+            exe);
+    while ( K->name ) {
+        printf("    %-15s %s\n", K->name, K->description);
+        K++;
+    }
+    printf("\n");
+}
+
+//
+
+static inline unsigned long
+offset_ijk(
+    unsigned long   *n,
+    unsigned long   i,
+    unsigned long   j,
+    unsigned long   k
+)
+{
+    return i * n[2] * n[1] + n[2] * j + k;
+}
+
+//
+
+static inline unsigned long
+offset_jki(
+    unsigned long   *n,
+    unsigned long   i,
+    unsigned long   j,
+    unsigned long   k
+)
+{
+    return j * n[0] * n[2] + n[0] * k + i;
+}
+
+//
+
+static inline unsigned long
+offset_jik(
+    unsigned long   *n,
+    unsigned long   i,
+    unsigned long   j,
+    unsigned long   k
+)
+{
+    return j * n[0] * n[2] + n[2] * i + k;
+}
+
+//
+
+/*
+ * An nd_iter_t walks the (i, j, k) elements of a box [lo, hi) in a loop
+ * order named outermost axis first (e.g. "jki"), keeping the element's
+ * offset in up to two layouts -- also named outermost axis first, so "jki"
+ * is the input file and "jik" the output -- current without multiplying:
+ * when an axis advances and the axes inside it wrap back to lo, each offset
+ * changes by a step precomputed by nd_iter_init().  wrapped is the number
+ * of axes that wrapped on the last nd_iter_next() (0 within the innermost
+ * axis, 3 once the box is done).
+ */
+typedef struct {
+    unsigned long   lo[3], hi[3], idx[3];
+    int             axis[3];            // loop axes, innermost first
+    long            step[2][3];
+    unsigned long   offset[2];
+    int             wrapped;
+} nd_iter_t;
+
+static int
+nd_axis(
+    char            c
+)
+{
+    switch ( c ) {
+        case 'i':
+            return 0;
+        case 'j':
+            return 1;
+        case 'k':
+            return 2;
+    }
+    return -1;
+}
+
+/*
+ * Per-axis strides of a layout (all zero for a NULL layout); false if the
+ * name is not a permutation of "ijk".
+ */
+static bool
+nd_layout_strides(
+    const unsigned long *n,
+    const char          *layout,
+    unsigned long       *stride
+)
+{
+    unsigned long       s = 1;
+    int                 d;
+    
+    stride[0] = stride[1] = stride[2] = 0;
+    if ( ! layout ) return true;
+    if ( strlen(layout) != 3 ) return false;
+    for ( d = 2; d >= 0; d-- ) {
+        int             a = nd_axis(layout[d]);
+        
+        if ( (a < 0) || stride[a] ) return false;
+        stride[a] = s;
+        s *= n[a];
+    }
+    return true;
+}
+
+/*
+ * lo and hi may be NULL for the whole (n1, n2, n3) array.  Returns false if
+ * the box is empty or an order/layout name is invalid.
+ */
+bool
+nd_iter_init(
+    nd_iter_t           *I,
+    const unsigned long *n,
+    const unsigned long *lo,
+    const unsigned long *hi,
+    const char          *order,
+    const char          *layout0,
+    const char          *layout1
+)
+{
+    unsigned long       stride[2][3], seen[3];
+    int                 d, l;
+    
+    if ( ! order || ! nd_layout_strides(n, order, seen) ) return false;
+    if ( ! nd_layout_strides(n, layout0, stride[0]) || ! nd_layout_strides(n, layout1, stride[1]) ) return false;
+    for ( d = 0; d < 3; d++ ) {
+        I->lo[d] = I->idx[d] = lo ? lo[d] : 0;
+        I->hi[d] = hi ? hi[d] : n[d];
+        if ( I->lo[d] >= I->hi[d] ) return false;
+        I->axis[d] = nd_axis(order[2 - d]);
+    }
+    for ( l = 0; l < 2; l++ ) {
+        unsigned long   back = 0;
+        
+        I->offset[l] = I->lo[0] * stride[l][0] + I->lo[1] * stride[l][1] + I->lo[2] * stride[l][2];
+        for ( d = 0; d < 3; d++ ) {
+            int         a = I->axis[d];
+            
+            I->step[l][d] = (long)stride[l][a] - (long)back;
+            back += (I->hi[a] - I->lo[a] - 1) * stride[l][a];
+        }
+    }
+    I->wrapped = 0;
+    return true;
+}
+
+static inline bool
+nd_iter_next(
+    nd_iter_t       *I
+)
+{
+    int             d;
+    
+    for ( d = 0; d < 3; d++ ) {
+        int         a = I->axis[d];
+        
+        if ( ++I->idx[a] < I->hi[a] ) {
+            I->offset[0] += I->step[0][d];
+            I->offset[1] += I->step[1][d];
+            I->wrapped = d;
+            return true;
+        }
+        I->idx[a] = I->lo[a];
+    }
+    I->wrapped = 3;
+    return false;
+}
+
+/*
+ * Fill v with the layout offsets of the box's elements in loop order (the
+ * synthetic data written in place of real input); returns the count.
+ */
+unsigned long
+nd_fill_offsets(
+    double              *v,
+    const unsigned long *n,
+    const unsigned long *lo,
+    const unsigned long *hi,
+    const char          *order,
+    const char          *layout
+)
+{
+    nd_iter_t           I;
+    double              *vp = v;
+    
+    if ( nd_iter_init(&I, n, lo, hi, order, layout, NULL) ) {
+        do {
+            *vp++ = I.offset[0];
+        } while ( nd_iter_next(&I) );
+    }
+    return vp - v;
+}
+
+//
+
+const char*
+memory_with_natural_unit(
+    size_t  bytes
+)
+{
+    static char*    prefix[] = {
+                            "",
+                            "Ki",
+                            "Mi",
+                            "Gi",
+                            "Ti",
+                            "Pi"
+                        };
+    static char     memstr[256];
+    int             prefix_idx = 0, prefix_max = (sizeof(prefix) / sizeof(char*)) - 1;
+    double          value = (double)bytes;
+    
+    while ( (value > 1024.0) && (prefix_idx < prefix_max) ) value /= 1024.0, prefix_idx++;
+    if ( prefix_idx > 0 ) {
+        prefix_max = snprintf(memstr, sizeof(memstr), "%.2lf %sB (%llu bytes)", value, prefix[prefix_idx], (unsigned long long)bytes);
+    } else {
+        prefix_max = snprintf(memstr, sizeof(memstr), "%llu B", (unsigned long long)bytes);
+    }
+    if ( prefix_max >= sizeof(memstr) ) {
+        fprintf(stderr, "CRITICAL:  memstr buffer too small in memory_with_natural_unit\n");
+        exit(ENOMEM);
+    }
+    return memstr;
+}
+
+//
+
+bool
+string_to_memory_size(
+    const char  *s,
+    size_t      *bytes
+)
+{
+    char                *eos = NULL;
+    double              v = strtod(s, &eos);
+
+    if ( (eos == s) || (v < 0.0) ) return false;
+    switch ( *eos ) {
+        case 'k':
+        case 'K':
+            v *= 1024.0;
+            eos++;
+            break;
+        case 'm':
+        case 'M':
+            v *= 1024.0 * 1024.0;
+            eos++;
+            break;
+        case 'g':
+        case 'G':
+            v *= 1024.0 * 1024.0 * 1024.0;
+            eos++;
+            break;
+        case 't':
+        case 'T':
+            v *= 1024.0 * 1024.0 * 1024.0 * 1024.0;
+            eos++;
+            break;
+    }
+    if ( *eos == 'i' ) eos++;
+    if ( (*eos == 'b') || (*eos == 'B') ) eos++;
+    if ( *eos ) return false;
+    //
+    // inf, nan and anything too large for a size_t are rejected, not cast:
+    //
+    if ( ! isfinite(v) || (v >= (double)SIZE_MAX) ) return false;
+    *bytes = (size_t)v;
+    return true;
+}
+
+//
+
+typedef struct {
+    size_t          budget;
+    const char      *source;
+} memory_budget_t;
+
+/*
+ * Only this fraction of the tightest limit found is handed out to the
+ * algorithms; the remainder covers the stack, libc buffers, page tables, etc.
+ */
+#define MEMORY_BUDGET_FRACTION  0.9
+
+static bool
+memory_budget_read_value(
+    const char          *path,
+    unsigned long long  *value
+)
+{
+    FILE                *fptr = fopen(path, "r");
+    char                line[64];
+    bool                rc = false;
+
+    if ( fptr ) {
+        if ( fgets(line, sizeof(line), fptr) ) {
+            char        *eos = NULL;
+
+            *value = strtoull(line, &eos, 10);
+            rc = (eos > line) ? true : false;
+        }
+        fclose(fptr);
+    }
+    return rc;
+}
+
+static void
+memory_budget_limit(
+    memory_budget_t     *mb,
+    unsigned long long  limit,
+    const char          *source
+)
+{
+    if ( limit < mb->budget ) {
+        mb->budget = limit;
+        mb->source = source;
+    }
+}
+
+static void
+memory_budget_cgroup(
+    memory_budget_t     *mb
+)
+{
+    FILE                *fptr = fopen("/proc/self/cgroup", "r");
+    char                line[4096], v2_path[4096], v1_path[4096];
+
+    if ( ! fptr ) return;
+    v2_path[0] = v1_path[0] = '\0';
+    while ( fgets(line, sizeof(line), fptr) ) {
+        char            *p = line + strlen(line);
+
+        while ( (p > line) && (*(p - 1) == '\n') ) *(--p) = '\0';
+        if ( strncmp(line, "0::", 3) == 0 ) {
+            strncpy(v2_path, line + 3, sizeof(v2_path) - 1);
+        } else if ( (p = strstr(line, ":memory:")) ) {
+            strncpy(v1_path, p + 8, sizeof(v1_path) - 1);
+        }
+    }
+    fclose(fptr);
+
+    if ( v2_path[0] ) {
+        char                dir[4096 + 32], path[4096 + 64], *p;
+        unsigned long long  max, current;
+
+        //
+        // Every ancestor's memory.max constrains us, so walk up the hierarchy
+        // to the root (which has no memory.max of its own):
+        //
+        snprintf(dir, sizeof(dir), "/sys/fs/cgroup%s", v2_path);
+        while ( (p = strrchr(dir, '/')) && (p - dir >= strlen("/sys/fs/cgroup")) ) {
+            snprintf(path, sizeof(path), "%s/memory.max", dir);
+            if ( memory_budget_read_value(path, &max) ) {
+                snprintf(path, sizeof(path), "%s/memory.current", dir);
+                if ( ! memory_budget_read_value(path, &current) ) current = 0;
+                memory_budget_limit(mb, (max > current) ? (max - current) : 0, "cgroup v2 memory.max - memory.current");
+            }
+            if ( p - dir == strlen("/sys/fs/cgroup") ) break;
+            *p = '\0';
+        }
+    }
+    if ( v1_path[0] ) {
+        char                path[4096 + 64];
+        unsigned long long  max, current;
+
+        snprintf(path, sizeof(path), "/sys/fs/cgroup/memory%s/memory.limit_in_bytes", v1_path);
+        if ( memory_budget_read_value(path, &max) ) {
+            snprintf(path, sizeof(path), "/sys/fs/cgroup/memory%s/memory.usage_in_bytes", v1_path);
+            if ( ! memory_budget_read_value(path, &current) ) current = 0;
+            memory_budget_limit(mb, (max > current) ? (max - current) : 0, "cgroup v1 memory.limit_in_bytes - memory.usage_in_bytes");
+        }
+    }
+}
+
+static void
+memory_budget_meminfo(
+    memory_budget_t     *mb
+)
+{
+    FILE                *fptr = fopen("/proc/meminfo", "r");
+    char                line[256];
+
+    if ( ! fptr ) return;
+    while ( fgets(line, sizeof(line), fptr) ) {
+        unsigned long long  kib;
+
+        if ( sscanf(line, "MemAvailable: %llu kB", &kib) == 1 ) {
+            memory_budget_limit(mb, kib * 1024ULL, "/proc/meminfo MemAvailable");
+            break;
+        }
+    }
+    fclose(fptr);
+}
+
+static void
+memory_budget_batch_job(
+    memory_budget_t     *mb
+)
+{
+    const char          *s;
+    unsigned long long  mib;
+
+    //
+    // Slurm exports the job's memory request in MiB, either per node or
+    // per allocated cpu:
+    //
+    if ( (s = getenv("SLURM_MEM_PER_NODE")) && (mib = strtoull(s, NULL, 10)) ) {
+        memory_budget_limit(mb, mib * 1024ULL * 1024ULL, "SLURM_MEM_PER_NODE");
+    } else if ( (s = getenv("SLURM_MEM_PER_CPU")) && (mib = strtoull(s, NULL, 10)) ) {
+        unsigned long long  n_cpu = 1;
+
+        if ( (s = getenv("SLURM_CPUS_ON_NODE")) ) n_cpu = strtoull(s, NULL, 10);
+        if ( n_cpu == 0 ) n_cpu = 1;
+        memory_budget_limit(mb, n_cpu * mib * 1024ULL * 1024ULL, "SLURM_MEM_PER_CPU x SLURM_CPUS_ON_NODE");
+    }
+}
+
+void
+memory_budget_detect(
+    memory_budget_t     *mb
+)
+{
+    mb->budget = (size_t)-1;
+    mb->source = "unlimited";
+    memory_budget_meminfo(mb);
+    memory_budget_cgroup(mb);
+    memory_budget_batch_job(mb);
+    if ( mb->budget != (size_t)-1 ) mb->budget = (size_t)(MEMORY_BUDGET_FRACTION * mb->budget);
+}
+
+//
+
+typedef struct {
+    unsigned long   slabs_per_batch;
+    unsigned long   k_per_tile;
+} matrix_plan_t;
+
+/*
+ * Size the matrix algorithm's n_buffers equally-sized buffers to the memory
+ * budget.  If whole n1 x n3 slabs fit, as many consecutive j slabs as fit are
+ * moved per transfer (both files are j-major, so a batch of slabs is a single
+ * contiguous region in each); otherwise each slab is split into tiles over k.
+ */
+bool
+matrix_plan_for_budget(
+    unsigned long   *n,
+    size_t          budget,
+    int             n_buffers,
+    matrix_plan_t   *plan
+)
+{
+    size_t          per_buffer = budget / n_buffers;
+    size_t          slab_len = sizeof(double) * n[0] * n[2];
+
+    if ( slab_len <= per_buffer ) {
+        plan->slabs_per_batch = per_buffer / slab_len;
+        if ( plan->slabs_per_batch > n[1] ) plan->slabs_per_batch = n[1];
+        plan->k_per_tile = n[2];
+        return true;
+    }
+    plan->slabs_per_batch = 1;
+    plan->k_per_tile = per_buffer / (sizeof(double) * n[0]);
+    return (plan->k_per_tile > 0) ? true : false;
+}
+
+//
+
+typedef struct {
+    off_t           src, dst;
+    double          value;
+} reorder_op_t;
+
+/*
+ * The reorder window collects the element-wise algorithms' (input offset,
+ * output offset) pairs.  When full, the pending reads are sorted by input
+ * offset and adjacent ones merged into single transfers; then the writes are
+ * sorted by output offset and merged the same way.  Every element is read
+ * before it is written and windows are retired in order, so the result is
+ * identical to issuing each element's read+write immediately.
+ */
+typedef struct {
+    file_handle_callbacks   *in_driver, *out_driver;
+    file_handle_t           *in_fh, *out_fh;
+    bool                    should_read, should_write;
+    size_t                  capacity, count;
+    reorder_op_t            *ops;
+    double                  *run;
+    unsigned long           n_elements, n_reads, n_writes;
+} reorder_window_t;
+
+bool
+reorder_window_init(
+    reorder_window_t        *rw,
+    size_t                  window_bytes,
+    file_handle_callbacks   *in_driver,
+    file_handle_t           *in_fh,
+    file_handle_callbacks   *out_driver,
+    file_handle_t           *out_fh,
+    bool                    should_read,
+    bool                    should_write
+)
+{
+    rw->capacity = window_bytes / (sizeof(reorder_op_t) + sizeof(double));
+    if ( rw->capacity == 0 ) return false;
+    rw->ops = (reorder_op_t*)malloc(rw->capacity * sizeof(reorder_op_t));
+    rw->run = (double*)malloc(rw->capacity * sizeof(double));
+    if ( ! rw->ops || ! rw->run ) {
+        if ( rw->ops ) free((void*)rw->ops);
+        if ( rw->run ) free((void*)rw->run);
+        return false;
+    }
+    rw->in_driver = in_driver;
+    rw->out_driver = out_driver;
+    rw->in_fh = in_fh;
+    rw->out_fh = out_fh;
+    rw->should_read = should_read;
+    rw->should_write = should_write;
+    rw->count = rw->n_elements = rw->n_reads = rw->n_writes = 0;
+    return true;
+}
+
+void
+reorder_window_destroy(
+    reorder_window_t        *rw
+)
+{
+    free((void*)rw->ops);
+    free((void*)rw->run);
+    rw->ops = NULL;
+    rw->run = NULL;
+    rw->capacity = 0;
+}
+
+static int
+reorder_op_cmp_src(
+    const void      *a,
+    const void      *b
+)
+{
+    off_t           d = ((const reorder_op_t*)a)->src - ((const reorder_op_t*)b)->src;
+    
+    return (d < 0) ? -1 : ((d > 0) ? 1 : 0);
+}
+
+static int
+reorder_op_cmp_dst(
+    const void      *a,
+    const void      *b
+)
+{
+    off_t           d = ((const reorder_op_t*)a)->dst - ((const reorder_op_t*)b)->dst;
+    
+    return (d < 0) ? -1 : ((d > 0) ? 1 : 0);
+}
+
+void
+reorder_window_flush(
+    reorder_window_t        *rw
+)
+{
+    size_t                  start, end, l;
+    
+    if ( rw->count == 0 ) return;
+    
+    if ( rw->should_read ) {
+        qsort(rw->ops, rw->count, sizeof(reorder_op_t), reorder_op_cmp_src);
+    } else {
+        for ( l = 0; l < rw->count; l++ ) rw->ops[l].value = rw->ops[l].src / sizeof(double);
+    }
+    for ( start = 0; rw->should_read && (start < rw->count); start = end ) {
+        ssize_t             n_bytes;
+        
+        for ( end = start + 1; (end < rw->count) && (rw->ops[end].src == rw->ops[end - 1].src + sizeof(double)); end++ );
+        if ( rw->in_driver->seek(rw->in_fh, rw->ops[start].src) < 0 ) {
+            fprintf(stderr, "ERROR:  unable to seek to %lld in input file (errno = %d)\n", (long long)rw->ops[start].src, errno);
+            exit(errno);
+        }
+        n_bytes = io_transfer_read(rw->in_driver, rw->in_fh, rw->run, sizeof(double) * (end - start));
+        if ( n_bytes != sizeof(double) * (end - start) ) {
+            if ( n_bytes >= 0 ) {
+                fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
+                exit(EINVAL);
+            }
+            fprintf(stderr, "ERROR:  unable to read %lu words at %lld from input file (errno = %d)\n", (unsigned long)(end - start), (long long)rw->ops[start].src, errno);
+            exit(errno);
+        }
+        for ( l = start; l < end; l++ ) rw->ops[l].value = rw->run[l - start];
+        rw->n_reads++;
+    }
+    
+    if ( rw->should_write ) qsort(rw->ops, rw->count, sizeof(reorder_op_t), reorder_op_cmp_dst);
+    for ( start = 0; rw->should_write && (start < rw->count); start = end ) {
+        ssize_t             n_bytes;
+        
+        rw->run[0] = rw->ops[start].value;
+        for ( end = start + 1; (end < rw->count) && (rw->ops[end].dst == rw->ops[end - 1].dst + sizeof(double)); end++ ) {
+            rw->run[end - start] = rw->ops[end].value;
+        }
+        if ( rw->out_driver->seek(rw->out_fh, rw->ops[start].dst) < 0 ) {
+            fprintf(stderr, "ERROR:  unable to seek to %lld in output file (errno = %d)\n", (long long)rw->ops[start].dst, errno);
+            exit(errno);
+        }
+        n_bytes = io_transfer_write(rw->out_driver, rw->out_fh, rw->run, sizeof(double) * (end - start));
+        if ( n_bytes != sizeof(double) * (end - start) ) {
+            fprintf(stderr, "ERROR:  unable to write %lu words at %lld to output file (errno = %d)\n", (unsigned long)(end - start), (long long)rw->ops[start].dst, errno);
+            exit(errno);
+        }
+        rw->n_writes++;
+    }
+    rw->count = 0;
+}
+
+static inline void
+reorder_window_add(
+    reorder_window_t        *rw,
+    off_t                   src,
+    off_t                   dst
+)
+{
+    rw->ops[rw->count].src = src;
+    rw->ops[rw->count].dst = dst;
+    rw->n_elements++;
+    if ( ++rw->count == rw->capacity ) reorder_window_flush(rw);
+}
+
+//
+
+typedef struct {
+    const char              *phase;
+    double                  interval;
+    FILE                    *series;
+    size_t                  bytes_total, bytes_done, slab_bytes;
+    size_t                  bytes_at_report, bytes_at_sample;
+    struct timespec         start, last_report, last_sample;
+    bool                    is_active;
+} progress_t;
+
+#define PROGRESS_DEFAULT_INTERVAL   30.0
+
+/*
+ * Set asynchronously by the SIGUSR1 handler; the next progress_advance()
+ * prints the current statistics.
+ */
+static volatile sig_atomic_t progress_dump_requested = 0;
+
+static void
+progress_sigusr1_handler(
+    int                     signum
+)
+{
+    progress_dump_requested = 1;
+}
+
+static double
+progress_seconds_between(
+    struct timespec         *t0,
+    struct timespec         *t1
+)
+{
+    return (t1->tv_sec - t0->tv_sec) + 1e-9 * (t1->tv_nsec - t0->tv_nsec);
+}
+
+void
+progress_start(
+    progress_t              *P,
+    const char              *phase,
+    size_t                  bytes_total,
+    size_t                  slab_bytes
+)
+{
+    P->phase = phase;
+    P->bytes_total = bytes_total;
+    P->slab_bytes = slab_bytes;
+    P->bytes_done = P->bytes_at_report = P->bytes_at_sample = 0;
+    clock_gettime(CLOCK_MONOTONIC, &P->start);
+    P->last_report = P->last_sample = P->start;
+    P->is_active = true;
+    if ( P->series ) fprintf(P->series, "# phase %s, %llu bytes\n", phase, (unsigned long long)bytes_total);
+}
+
+static void
+progress_print(
+    progress_t              *P,
+    struct timespec         *now,
+    const char              *why
+)
+{
+    double                  elapsed = progress_seconds_between(&P->start, now);
+    double                  dt = progress_seconds_between(&P->last_report, now);
+    double                  rate = (elapsed > 0.0) ? (P->bytes_done / elapsed) : 0.0;
+    double                  recent_rate = (dt > 0.0) ? ((P->bytes_done - P->bytes_at_report) / dt) : 0.0;
+    
+    printf("INFO:  %s %s:  %.2lf%% (%.2lf of %lu slabs) after %.1lf s, %.3lf GiB/s over last %.1lf s, %.3lf GiB/s overall",
+            P->phase, why,
+            (P->bytes_total > 0) ? (100.0 * P->bytes_done / P->bytes_total) : 100.0,
+            (double)P->bytes_done / P->slab_bytes, (unsigned long)(P->bytes_total / P->slab_bytes),
+            elapsed, recent_rate / (1024.0 * 1024.0 * 1024.0), dt, rate / (1024.0 * 1024.0 * 1024.0));
+    if ( rate > 0.0 ) {
+        printf(", ETA %.1lf s\n", (P->bytes_total - P->bytes_done) / rate);
+    } else {
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+static void
+progress_sample(
+    progress_t              *P,
+    struct timespec         *now
+)
+{
+    double                  dt = progress_seconds_between(&P->last_sample, now);
+    
+    fprintf(P->series, "%.3lf %llu %.6lf\n",
+            progress_seconds_between(&P->start, now), (unsigned long long)P->bytes_done,
+            (dt > 0.0) ? ((P->bytes_done - P->bytes_at_sample) / dt / (1024.0 * 1024.0 * 1024.0)) : 0.0);
+    P->bytes_at_sample = P->bytes_done;
+    P->last_sample = *now;
+}
+
+void
+progress_check(
+    progress_t              *P
+)
+{
+    struct timespec         now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if ( progress_dump_requested ) {
+        progress_dump_requested = 0;
+        progress_print(P, &now, "statistics (SIGUSR1)");
+    }
+    if ( P->series && (progress_seconds_between(&P->last_sample, &now) >= 1.0) ) progress_sample(P, &now);
+    if ( (P->interval > 0.0) && (progress_seconds_between(&P->last_report, &now) >= P->interval) ) {
+        progress_print(P, &now, "progress");
+        P->bytes_at_report = P->bytes_done;
+        P->last_report = now;
+    }
+}
+
+/*
+ * Called by the algorithms as each unit of work completes; bytes counts the
+ * logical tensor data covered.
+ */
+static inline void
+progress_advance(
+    progress_t              *P,
+    size_t                  bytes
+)
+{
+    P->bytes_done += bytes;
+    if ( P->is_active ) progress_check(P);
+}
+
+void
+progress_finish(
+    progress_t              *P
+)
+{
+    if ( P->is_active && P->series ) {
+        struct timespec     now;
+        
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        progress_sample(P, &now);
+        fflush(P->series);
+    }
+    P->is_active = false;
+}
+
+//
+
+typedef struct {
+    unsigned long           n[3];
+    algorithm_t             algorithm;
+    file_handle_callbacks   *in_driver, *out_driver;
+    file_handle_t           in_fh, out_fh;
+    size_t                  mem_budget;
+    reorder_window_t        reorder;
+    bool                    should_read, should_write;
+    progress_t              progress;
+    int                     n_threads;
+    transpose_kernel_t      *transpose;
+    double                  transpose_seconds;
+    size_t                  transpose_bytes;
+    bool                    no_fast_path;
+    int                     uring_depth;
+    bool                    uring_sqpoll;
+    int                     async_depth;
+    bool                    preallocate;
+    bool                    io_hints;
+    matrix_plan_t           plan;
+} transform_t;
+
+static inline double
+transform_seconds_since(
+    struct timespec         *t0
+)
+{
+    struct timespec         t1;
+    
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return (t1.tv_sec - t0->tv_sec) + 1e-9 * (t1.tv_nsec - t0->tv_nsec);
+}
+
+/*
+ * Write the jki-ordered input file using the transform's algorithm.
+ */
+void
+transform_init_input(
+    transform_t             *T
+)
+{
+    file_handle_callbacks   *in_driver = T->in_driver;
+    file_handle_t           *in_fh = &T->in_fh;
+    unsigned long           *n = T->n, i, j, k;
+    
+    switch ( T->algorithm ) {
+
+        case algorithm_invalid:
+        case algorithm_max:
+            break;
+        
+        case algorithm_ijk_map:
+        case algorithm_jki_map:
+        case algorithm_jik_map: {
+            //
+            // Each map writes, in its own loop order, the element's offset
+            // in that order's layout (jik_map loops as ijk):
+            //
+            nd_iter_t   I;
+            const char  *order = (T->algorithm == algorithm_jki_map) ? "jki" : "ijk";
+            const char  *layout = (T->algorithm == algorithm_jik_map) ? "jik" : order;
+            size_t      row_len;
+            
+            if ( ! nd_iter_init(&I, n, NULL, NULL, order, layout, NULL) ) break;
+            row_len = sizeof(double) * n[I.axis[0]];
+            do {
+                ssize_t n_bytes;
+                double  v = I.offset[0];
+                
+                if ( I.wrapped ) progress_advance(&T->progress, row_len);
+                n_bytes = io_transfer_write(in_driver, in_fh, &v, sizeof(v));
+                if ( n_bytes != sizeof(v) ) {
+                    fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to input file (errno = %d)\n", I.idx[0], I.idx[1], I.idx[2], errno);
+                    exit(errno);
+                }
+            } while ( nd_iter_next(&I) );
+            progress_advance(&T->progress, row_len);
+            break;
+        }
+        
+        case algorithm_vector_input: {
+            size_t      v_len = sizeof(double) * n[0];
+            double      *v = (double*)malloc(v_len);
+                
+            if ( ! v ) {
+                fprintf(stderr, "ERROR:  unable to allocate init read vector in vector_input\n");
+                exit(ENOMEM);
+            }
+            printf("INFO:  init read vector of size %s allocated\n", memory_with_natural_unit(v_len));
+            
+            for ( j=0; j<n[1]; j++ ) {
+                for ( k=0; k<n[2]; k++ ) {
+                    ssize_t         n_bytes;
+                    unsigned long   base = offset_jki(n, 0, j, k);
+                    
+                    for ( i=0; i<n[0]; i++ ) v[i] = base + i;
+                    n_bytes = io_transfer_write(in_driver, in_fh, v, v_len);
+                    if ( n_bytes != v_len ) {
+                        fprintf(stderr, "ERROR:  unable to write (..., %lu, %lu) to input file (errno = %d)\n", j, k, errno);
+                        exit(errno);
+                    }
+                    progress_advance(&T->progress, v_len);
+                }
+            }
+            free((void*)v);
+            break;
+        }
+        
+        case algorithm_vector_output: {
+            size_t      v_len = sizeof(double) * n[2];
+            double      *v = (double*)malloc(v_len);
+                
+            if ( ! v ) {
+                fprintf(stderr, "ERROR:  unable to allocate init write vector in vector_input\n");
+                exit(ENOMEM);
+            }
+            printf("INFO:  init write vector of size %s allocated\n", memory_with_natural_unit(v_len));
+            
+            for ( j=0; j<n[1]; j++ ) {
+                for ( i=0; i<n[0]; i++ ) {
+                    ssize_t         n_bytes;
+                    unsigned long   fp = offset_jki(n, i, j, 0);
+                    
+                    for ( k=0; k<n[2]; k++, fp += n[0] ) v[k] = fp;
+                    n_bytes = io_transfer_write(in_driver, in_fh, v, v_len);
+                    if ( n_bytes != v_len ) {
+                        fprintf(stderr, "ERROR:  unable to write (%lu, %lu, ...) to input file (errno = %d)\n", i, j, errno);
+                        exit(errno);
+                    }
+                    progress_advance(&T->progress, v_len);
+                }
+            }
+            free((void*)v);
+            break;
+        }
+        
+        case algorithm_matrix:
+        case algorithm_matrix_parallel:
+        case algorithm_matrix_uring:
+        case algorithm_matrix_async: {
+            matrix_plan_t   plan;
+            size_t          v_len;
+            double          *v;
+            unsigned long   j_end, k0, k_end;
+            
+            if ( ! matrix_plan_for_budget(n, T->mem_budget, 1, &plan) ) {
+                fprintf(stderr, "ERROR:  memory budget too small for init read+write matrix in matrix\n");
+                exit(ENOMEM);
+            }
+            v_len = sizeof(double) * plan.slabs_per_batch * n[0] * plan.k_per_tile;
+            v = (double*)malloc(v_len);
+            if ( ! v ) {
+                fprintf(stderr, "ERROR:  unable to allocate init read+write matrix in matrix\n");
+                exit(ENOMEM);
+            }
+            printf("INFO:  init read+write matrix of size %s allocated (%lu slab(s) x %lu k per transfer)\n",
+                    memory_with_natural_unit(v_len), plan.slabs_per_batch, plan.k_per_tile);
+        
+            for ( j=0; j<n[1]; j = j_end ) {
+                j_end = j + plan.slabs_per_batch;
+                if ( j_end > n[1] ) j_end = n[1];
+                for ( k0=0; k0<n[2]; k0 = k_end ) {
+                    ssize_t         n_bytes;
+                    double          *vp = v;
+                    unsigned long   lo[3] = { 0, j, k0 }, hi[3] = { n[0], j_end, 0 };
+                    
+                    k_end = k0 + plan.k_per_tile;
+                    if ( k_end > n[2] ) k_end = n[2];
+                    hi[2] = k_end;
+                    vp += nd_fill_offsets(v, n, lo, hi, "jki", "jki");
+                    n_bytes = io_transfer_write(in_driver, in_fh, v, sizeof(double) * (vp - v));
+                    if ( n_bytes != sizeof(double) * (vp - v) ) {
+                        fprintf(stderr, "ERROR:  unable to write (..., %lu, %lu) to input file (errno = %d)\n", j, k0, errno);
+                        exit(errno);
+                    }
+                    progress_advance(&T->progress, sizeof(double) * (vp - v));
+                }
+            }
+            free((void*)v);
+            break;
+        }
+        
+    }
+}
+
+//
+
+/*
+ * Work shared by the matrix_parallel threads:  the (j batch, k tile) work
+ * items are handed out in order from next_item, and each thread moves its
+ * items through its own pair of buffers and its own clones of the input and
+ * output handles.
+ */
+typedef struct {
+    transform_t             *T;
+    matrix_plan_t           plan;
+    unsigned long           n_k_tiles, n_items, next_item;
+    pthread_mutex_t         lock;
+} matrix_parallel_t;
+
+static void*
+matrix_parallel_worker(
+    void                    *context
+)
+{
+    matrix_parallel_t       *M = (matrix_parallel_t*)context;
+    transform_t             *T = M->T;
+    file_handle_callbacks   *in_driver = T->in_driver, *out_driver = T->out_driver;
+    unsigned long           *n = T->n, i;
+    size_t                  v_len = M->plan.slabs_per_batch * n[0] * M->plan.k_per_tile;
+    double                  *v1 = (double*)malloc(2 * sizeof(double) * v_len), *v2 = v1 + v_len;
+    double                  *vt = T->transpose->in_place ? v1 : v2;
+    double                  transpose_seconds = 0.0;
+    size_t                  transpose_bytes = 0;
+    file_handle_t           in_clone, out_clone, *in_fh = NULL, *out_fh = NULL;
+    bool                    is_in_cloned = false, is_out_cloned = false;
+    
+    if ( ! v1 ) {
+        fprintf(stderr, "ERROR:  unable to allocate read+write matrices in matrix_parallel\n");
+        exit(ENOMEM);
+    }
+    if ( T->should_read && ! (in_fh = io_transfer_worker_handle(in_driver, &T->in_fh, &in_clone, &is_in_cloned)) ) {
+        fprintf(stderr, "ERROR:  unable to clone the input file handle (errno = %d)\n", errno);
+        exit(errno);
+    }
+    if ( T->should_write && ! (out_fh = io_transfer_worker_handle(out_driver, &T->out_fh, &out_clone, &is_out_cloned)) ) {
+        fprintf(stderr, "ERROR:  unable to clone the output file handle (errno = %d)\n", errno);
+        exit(errno);
+    }
+    while ( 1 ) {
+        unsigned long       item, j, j_end, k0, k_end, jj, nk, slab_len;
+        size_t              xfer_len;
+        ssize_t             n_bytes;
+        off_t               fp;
+        
+        pthread_mutex_lock(&M->lock);
+        item = M->next_item++;
+        pthread_mutex_unlock(&M->lock);
+        if ( item >= M->n_items ) break;
+        
+        j = (item / M->n_k_tiles) * M->plan.slabs_per_batch;
+        j_end = j + M->plan.slabs_per_batch;
+        if ( j_end > n[1] ) j_end = n[1];
+        k0 = (item % M->n_k_tiles) * M->plan.k_per_tile;
+        k_end = k0 + M->plan.k_per_tile;
+        if ( k_end > n[2] ) k_end = n[2];
+        nk = k_end - k0;
+        slab_len = n[0] * nk;
+        xfer_len = sizeof(double) * (j_end - j) * slab_len;
+        
+        if ( T->should_read ) {
+            fp = sizeof(double) * offset_jki(n, 0, j, k0);
+            n_bytes = io_transfer_at(in_driver, in_fh, v1, xfer_len, fp, false);
+            if ( n_bytes != xfer_len ) {
+                if ( n_bytes >= 0 ) {
+                    fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
+                    exit(EINVAL);
+                }
+                fprintf(stderr, "ERROR:  unable to read (..., %lu, %lu) from input file (errno = %d)\n", j, k0, errno);
+                exit(errno);
+            }
+            if ( T->should_write ) {
+                struct timespec t0;
+                
+                clock_gettime(CLOCK_MONOTONIC, &t0);
+                for ( jj=0; jj<(j_end - j); jj++ ) {
+                    T->transpose->fn(v1 + jj * slab_len, vt + jj * slab_len, n[0], nk);
+                }
+                transpose_seconds += transform_seconds_since(&t0);
+                transpose_bytes += 2 * xfer_len;
+            }
+        } else {
+            unsigned long   lo[3] = { 0, j, k0 }, hi[3] = { n[0], j_end, k0 + nk };
+            
+            nd_fill_offsets(vt, n, lo, hi, "jik", "jki");
+        }
+        if ( T->should_write ) {
+            if ( nk == n[2] ) {
+                fp = sizeof(double) * offset_jik(n, 0, j, 0);
+                n_bytes = io_transfer_at(out_driver, out_fh, vt, xfer_len, fp, true);
+                if ( n_bytes != xfer_len ) {
+                    fprintf(stderr, "ERROR:  unable to write (..., %lu, ...) to output file (errno = %d)\n", j, errno);
+                    exit(errno);
+                }
+            } else {
+                for ( i=0; i<n[0]; i++ ) {
+                    fp = sizeof(double) * offset_jik(n, i, j, k0);
+                    n_bytes = io_transfer_at(out_driver, out_fh, vt + i * nk, sizeof(double) * nk, fp, true);
+                    if ( n_bytes != sizeof(double) * nk ) {
+                        fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to output file (errno = %d)\n", i, j, k0, errno);
+                        exit(errno);
+                    }
+                }
+            }
+        }
+        pthread_mutex_lock(&M->lock);
+        progress_advance(&T->progress, xfer_len);
+        pthread_mutex_unlock(&M->lock);
+    }
+    pthread_mutex_lock(&M->lock);
+    T->transpose_seconds += transpose_seconds;
+    T->transpose_bytes += transpose_bytes;
+    pthread_mutex_unlock(&M->lock);
+    if ( is_in_cloned ) in_driver->close(&in_clone);
+    if ( is_out_cloned ) out_driver->close(&out_clone);
+    free((void*)v1);
+    return NULL;
+}
+
+//
+
+/*
+ * Fill vt with the jik-ordered (j..j_end, k0..k0+nk) batch:  the transpose of
+ * the batch read into v1 or, when nothing is read, the synthesized values.
+ * Not thread-safe (the transpose statistics are updated).
+ */
+static void
+matrix_batch_produce(
+    transform_t             *T,
+    double                  *v1,
+    double                  *vt,
+    unsigned long           j,
+    unsigned long           j_end,
+    unsigned long           k0,
+    unsigned long           nk
+)
+{
+    unsigned long           *n = T->n, jj, slab_len = n[0] * nk;
+    
+    if ( T->should_read ) {
+        struct timespec     t0;
+        
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for ( jj=0; jj<(j_end - j); jj++ ) {
+            T->transpose->fn(v1 + jj * slab_len, vt + jj * slab_len, n[0], nk);
+        }
+        T->transpose_seconds += transform_seconds_since(&t0);
+        T->transpose_bytes += 2 * sizeof(double) * (j_end - j) * slab_len;
+    } else {
+        unsigned long   lo[3] = { 0, j, k0 }, hi[3] = { n[0], j_end, k0 + nk };
+        
+        nd_fill_offsets(vt, n, lo, hi, "jik", "jki");
+    }
+}
+
+//
+
+/*
+ * The matrix_uring pipeline:  each of depth slots owns a read buffer and a
+ * write buffer and carries one (j batch, k tile) work item through its read
+ * ops, the transpose and its write ops.  Transfers larger than the transfer
+ * chunk size and the n1 separate runs of a k tile are individual ops; short
+ * transfers are re-queued for the remainder.
+ */
+#define URING_DEFAULT_DEPTH         4
+
+typedef enum {
+    uring_slot_idle = 0,
+    uring_slot_reading,
+    uring_slot_writing
+} uring_slot_state_t;
+
+typedef struct {
+    char                    *buffer;
+    size_t                  len;
+    off_t                   offset;
+    bool                    is_queued;
+} uring_op_t;
+
+typedef struct {
+    uring_slot_state_t      state;
+    double                  *v1, *v2;
+    unsigned long           j, j_end, k0, nk;
+    size_t                  xfer_len;
+    uring_op_t              *ops;
+    unsigned                n_ops, n_remaining, scan;
+} uring_slot_t;
+
+/*
+ * Fill the slot's op list with buffer_len bytes at offset split into chunks.
+ */
+static void
+uring_slot_add_ops(
+    uring_slot_t            *S,
+    char                    *buffer,
+    size_t                  buffer_len,
+    off_t                   offset
+)
+{
+    size_t                  chunk = io_transfer_config.chunk_size;
+    
+    while ( buffer_len ) {
+        size_t              len = (buffer_len < chunk) ? buffer_len : chunk;
+        
+        S->ops[S->n_ops++] = (uring_op_t){ buffer, len, offset, true };
+        buffer += len, offset += len, buffer_len -= len;
+    }
+    S->n_remaining = S->n_ops;
+}
+
+/*
+ * Transpose (or synthesize) the slot's batch into its write buffer and queue
+ * the output writes.
+ */
+static void
+uring_slot_start_write(
+    transform_t             *T,
+    uring_slot_t            *S
+)
+{
+    unsigned long           *n = T->n, i;
+    double                  *vt = T->transpose->in_place ? S->v1 : S->v2;
+    
+    matrix_batch_produce(T, S->v1, vt, S->j, S->j_end, S->k0, S->nk);
+    S->n_ops = 0;
+    S->scan = 0;
+    if ( S->nk == n[2] ) {
+        uring_slot_add_ops(S, (char*)vt, S->xfer_len, sizeof(double) * offset_jik(n, 0, S->j, 0));
+    } else {
+        for ( i=0; i<n[0]; i++ ) {
+            S->ops[S->n_ops++] = (uring_op_t){ (char*)(vt + i * S->nk), sizeof(double) * S->nk, sizeof(double) * offset_jik(n, i, S->j, S->k0), true };
+        }
+        S->n_remaining = S->n_ops;
+    }
+    S->state = uring_slot_writing;
+}
+
+/*
+ * Returns false (before any i/o was done) if io_uring cannot be used.
+ */
+bool
+matrix_uring_process(
+    transform_t             *T
+)
+{
+    unsigned long           *n = T->n;
+    int                     depth = (T->uring_depth > 0) ? T->uring_depth : URING_DEFAULT_DEPTH, s;
+    int                     fds[2] = { -1, -1 };
+    matrix_plan_t           plan;
+    unsigned long           n_k_tiles, n_items, next_item = 0, n_done = 0;
+    size_t                  v_len;
+    unsigned                max_ops, entries, n_inflight = 0;
+    uring_t                 R;
+    uring_slot_t            slots[depth];
+    struct iovec            iovs[depth];
+    double                  *pool;
+    bool                    fixed_buffers, fixed_files;
+    
+    if ( T->should_read && (! T->in_driver->fileno || ((fds[0] = T->in_driver->fileno(&T->in_fh)) < 0)) ) return false;
+    if ( T->should_write && (! T->out_driver->fileno || ((fds[1] = T->out_driver->fileno(&T->out_fh)) < 0)) ) return false;
+    
+    if ( ! matrix_plan_for_budget(n, T->mem_budget / depth, 2, &plan) ) {
+        fprintf(stderr, "ERROR:  memory budget too small for %d x read+write matrices in matrix_uring\n", depth);
+        exit(ENOMEM);
+    }
+    T->plan = plan;
+    v_len = plan.slabs_per_batch * n[0] * plan.k_per_tile;
+    n_k_tiles = (n[2] + plan.k_per_tile - 1) / plan.k_per_tile;
+    n_items = ((n[1] + plan.slabs_per_batch - 1) / plan.slabs_per_batch) * n_k_tiles;
+    max_ops = (sizeof(double) * v_len + io_transfer_config.chunk_size - 1) / io_transfer_config.chunk_size;
+    if ( max_ops < n[0] ) max_ops = n[0];
+    for ( entries = 8; (entries < depth * max_ops) && (entries < URING_MAX_ENTRIES); entries *= 2 );
+    
+    if ( ! uring_init(&R, entries, T->uring_sqpoll) ) {
+        printf("WARNING:  io_uring setup failed (errno = %d)\n", errno);
+        return false;
+    }
+    if ( ! (pool = (double*)malloc(2 * sizeof(double) * v_len * depth)) ) {
+        fprintf(stderr, "ERROR:  unable to allocate read+write matrices in matrix_uring\n");
+        exit(ENOMEM);
+    }
+    for ( s = 0; s < depth; s++ ) {
+        slots[s] = (uring_slot_t){ uring_slot_idle, pool + 2 * s * v_len, pool + (2 * s + 1) * v_len };
+        if ( ! (slots[s].ops = (uring_op_t*)malloc(max_ops * sizeof(uring_op_t))) ) {
+            fprintf(stderr, "ERROR:  unable to allocate matrix_uring op lists\n");
+            exit(ENOMEM);
+        }
+        iovs[s].iov_base = slots[s].v1;
+        iovs[s].iov_len = 2 * sizeof(double) * v_len;
+    }
+    //
+    // Registered buffers are pinned once instead of per request, and
+    // registered files skip the per-request file table lookup; both are
+    // optional (e.g. RLIMIT_MEMLOCK may be too small for the buffers):
+    //
+    fixed_buffers = (uring_sys_register(R.fd, IORING_REGISTER_BUFFERS, iovs, depth) == 0) ? true : false;
+    fixed_files = (uring_sys_register(R.fd, IORING_REGISTER_FILES, fds, 2) == 0) ? true : false;
+    printf("INFO:  io_uring of %u entries%s, %d slot(s) of 2 x %s (%lu slab(s) x %lu k per transfer), %s buffers, %s files\n",
+            R.sq_entries, R.sqpoll ? " with SQPOLL" : "", depth, memory_with_natural_unit(sizeof(double) * v_len),
+            plan.slabs_per_batch, plan.k_per_tile, fixed_buffers ? "registered" : "unregistered", fixed_files ? "registered" : "unregistered");
+    
+    while ( n_done < n_items ) {
+        struct io_uring_cqe *cqe;
+        
+        //
+        // Start the next work items on idle slots:
+        //
+        for ( s = 0; (s < depth) && (next_item < n_items); s++ ) {
+            uring_slot_t    *S = &slots[s];
+            unsigned long   k_end;
+            
+            if ( S->state != uring_slot_idle ) continue;
+            S->j = (next_item / n_k_tiles) * plan.slabs_per_batch;
+            S->j_end = S->j + plan.slabs_per_batch;
+            if ( S->j_end > n[1] ) S->j_end = n[1];
+            S->k0 = (next_item % n_k_tiles) * plan.k_per_tile;
+            k_end = S->k0 + plan.k_per_tile;
+            if ( k_end > n[2] ) k_end = n[2];
+            S->nk = k_end - S->k0;
+            S->xfer_len = sizeof(double) * (S->j_end - S->j) * n[0] * S->nk;
+            next_item++;
+            if ( T->should_read ) {
+                S->n_ops = 0;
+                S->scan = 0;
+                uring_slot_add_ops(S, (char*)S->v1, S->xfer_len, sizeof(double) * offset_jki(n, 0, S->j, S->k0));
+                S->state = uring_slot_reading;
+            } else {
+                uring_slot_start_write(T, S);
+            }
+        }
+        
+        //
+        // Queue every op the submission ring has room for:
+        //
+        for ( s = 0; s < depth; s++ ) {
+            uring_slot_t    *S = &slots[s];
+            bool            is_write = (S->state == uring_slot_writing) ? true : false;
+            
+            for ( ; (S->state != uring_slot_idle) && (S->scan < S->n_ops); S->scan++ ) {
+                uring_op_t          *op = &S->ops[S->scan];
+                struct io_uring_sqe *sqe;
+                
+                if ( ! op->is_queued ) continue;
+                if ( ! (sqe = uring_get_sqe(&R)) ) break;
+                uring_prep_rw(sqe,
+                        fixed_buffers ? (is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED) : (is_write ? IORING_OP_WRITE : IORING_OP_READ),
+                        fixed_files ? (is_write ? 1 : 0) : fds[is_write ? 1 : 0],
+                        op->buffer, op->len, op->offset, fixed_buffers ? s : -1, fixed_files,
+                        (unsigned long long)s * max_ops + S->scan);
+                op->is_queued = false;
+                n_inflight++;
+            }
+        }
+        if ( uring_submit(&R, n_inflight ? 1 : 0) < 0 ) {
+            fprintf(stderr, "ERROR:  io_uring submit failed (errno = %d)\n", errno);
+            exit(errno);
+        }
+        
+        //
+        // Retire completions; a finished read is transposed right away while
+        // the other slots' transfers are still in flight:
+        //
+        while ( (cqe = uring_peek_cqe(&R)) ) {
+            uring_slot_t    *S = &slots[cqe->user_data / max_ops];
+            unsigned        op_idx = cqe->user_data % max_ops;
+            uring_op_t      *op = &S->ops[op_idx];
+            int             res = cqe->res;
+            
+            uring_cqe_seen(&R);
+            n_inflight--;
+            if ( (res == -EINTR) || (res == -EAGAIN) ) {
+                res = 0;
+            } else if ( res < 0 ) {
+                fprintf(stderr, "ERROR:  unable to %s %lu bytes at %lld (errno = %d)\n",
+                        (S->state == uring_slot_writing) ? "write" : "read", (unsigned long)op->len, (long long)op->offset, -res);
+                exit(-res);
+            } else if ( res == 0 ) {
+                if ( S->state == uring_slot_reading ) {
+                    fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
+                    exit(EINVAL);
+                }
+                fprintf(stderr, "ERROR:  unable to write %lu bytes at %lld to output file (errno = %d)\n", (unsigned long)op->len, (long long)op->offset, EIO);
+                exit(EIO);
+            }
+            op->buffer += res, op->offset += res, op->len -= res;
+            if ( op->len ) {
+                op->is_queued = true;
+                if ( op_idx < S->scan ) S->scan = op_idx;
+                continue;
+            }
+            if ( --S->n_remaining ) continue;
+            
+            if ( (S->state == uring_slot_reading) && T->should_write ) {
+                uring_slot_start_write(T, S);
+            } else {
+                S->state = uring_slot_idle;
+                n_done++;
+                progress_advance(&T->progress, S->xfer_len);
+            }
+        }
+    }
+    uring_destroy(&R);
+    for ( s = 0; s < depth; s++ ) free((void*)slots[s].ops);
+    free((void*)pool);
+    return true;
+}
+
+//
+
+/*
+ * The matrix_async pipeline, written against the driver's asynchronous
+ * callbacks:  work item w lives in slot w % depth, whose reads for item
+ * w + depth are submitted as soon as item w is transposed.  The writes of
+ * item w are only waited for when the slot is next transposed into, so with
+ * a real asynchronous backend both directions overlap the transposes.  An
+ * in-place kernel writes from the buffer it read into, so the slot's two
+ * buffers swap roles after each item.
+ */
+#define ASYNC_DEFAULT_DEPTH         2
+
+typedef struct {
+    double                  *v1, *v2;
+    unsigned long           j, j_end, k0, nk;
+    size_t                  xfer_len;
+    io_request_t            **reads, **writes;
+    int                     n_reads, n_writes;
+} async_slot_t;
+
+static void
+async_slot_submit(
+    file_handle_callbacks   *io_driver,
+    file_handle_t           *fh,
+    io_request_t            **reqs,
+    int                     *n_reqs,
+    char                    *buffer,
+    size_t                  buffer_len,
+    off_t                   offset,
+    bool                    is_write
+)
+{
+    size_t                  chunk = io_transfer_config.chunk_size;
+    
+    while ( buffer_len ) {
+        size_t              len = (buffer_len < chunk) ? buffer_len : chunk;
+        io_request_t        *req;
+        
+        if ( is_write ) {
+            req = io_driver->submit_write(fh, buffer, len, offset);
+        } else {
+            req = io_driver->submit_read(fh, buffer, len, offset);
+        }
+        if ( ! req ) {
+            fprintf(stderr, "ERROR:  unable to submit %s of %lu bytes at %lld (errno = %d)\n", is_write ? "write" : "read", (unsigned long)len, (long long)offset, errno);
+            exit(errno);
+        }
+        reqs[(*n_reqs)++] = req;
+        buffer += len, offset += len, buffer_len -= len;
+    }
+}
+
+static void
+async_slot_wait(
+    file_handle_callbacks   *io_driver,
+    io_request_t            **reqs,
+    int                     *n_reqs,
+    bool                    is_write
+)
+{
+    int                     r;
+    
+    if ( ! io_driver->wait_all(reqs, *n_reqs) ) {
+        fprintf(stderr, "ERROR:  unable to %s %s file (errno = %d)\n", is_write ? "write to" : "read from", is_write ? "output" : "input", errno);
+        exit(errno);
+    }
+    for ( r = 0; r < *n_reqs; r++ ) {
+        if ( reqs[r]->done != reqs[r]->buffer_len ) {
+            fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
+            exit(EINVAL);
+        }
+        io_request_free(reqs[r]);
+    }
+    *n_reqs = 0;
+}
+
+static void
+async_slot_start(
+    transform_t             *T,
+    async_slot_t            *S,
+    matrix_plan_t           *plan,
+    unsigned long           n_k_tiles,
+    unsigned long           item
+)
+{
+    unsigned long           *n = T->n, k_end;
+    
+    S->j = (item / n_k_tiles) * plan->slabs_per_batch;
+    S->j_end = S->j + plan->slabs_per_batch;
+    if ( S->j_end > n[1] ) S->j_end = n[1];
+    S->k0 = (item % n_k_tiles) * plan->k_per_tile;
+    k_end = S->k0 + plan->k_per_tile;
+    if ( k_end > n[2] ) k_end = n[2];
+    S->nk = k_end - S->k0;
+    S->xfer_len = sizeof(double) * (S->j_end - S->j) * n[0] * S->nk;
+    if ( T->should_read ) {
+        async_slot_submit(T->in_driver, &T->in_fh, S->reads, &S->n_reads, (char*)S->v1, S->xfer_len, sizeof(double) * offset_jki(n, 0, S->j, S->k0), false);
+    }
+}
+
+void
+matrix_async_process(
+    transform_t             *T
+)
+{
+    file_handle_callbacks   *in_driver = T->in_driver, *out_driver = T->out_driver;
+    unsigned long           *n = T->n, i, item;
+    int                     depth = (T->async_depth > 0) ? T->async_depth : ASYNC_DEFAULT_DEPTH, s;
+    matrix_plan_t           plan;
+    unsigned long           n_k_tiles, n_items;
+    size_t                  v_len;
+    unsigned                max_reqs;
+    async_slot_t            slots[depth];
+    double                  *pool;
+    io_request_t            **req_pool;
+    
+    if ( ! matrix_plan_for_budget(n, T->mem_budget / depth, 2, &plan) ) {
+        fprintf(stderr, "ERROR:  memory budget too small for %d x read+write matrices in matrix_async\n", depth);
+        exit(ENOMEM);
+    }
+    T->plan = plan;
+    v_len = plan.slabs_per_batch * n[0] * plan.k_per_tile;
+    n_k_tiles = (n[2] + plan.k_per_tile - 1) / plan.k_per_tile;
+    n_items = ((n[1] + plan.slabs_per_batch - 1) / plan.slabs_per_batch) * n_k_tiles;
+    max_reqs = (sizeof(double) * v_len + io_transfer_config.chunk_size - 1) / io_transfer_config.chunk_size;
+    if ( max_reqs < n[0] ) max_reqs = n[0];
+    
+    if ( ! (pool = (double*)malloc(2 * sizeof(double) * v_len * depth)) || ! (req_pool = (io_request_t**)malloc(2 * sizeof(io_request_t*) * max_reqs * depth)) ) {
+        fprintf(stderr, "ERROR:  unable to allocate read+write matrices in matrix_async\n");
+        exit(ENOMEM);
+    }
+    for ( s = 0; s < depth; s++ ) {
+        slots[s] = (async_slot_t){ pool + 2 * s * v_len, pool + (2 * s + 1) * v_len, 0, 0, 0, 0, 0, req_pool + 2 * s * max_reqs, req_pool + (2 * s + 1) * max_reqs, 0, 0 };
+    }
+    printf("INFO:  %d asynchronous slot(s) of 2 x %s (%lu slab(s) x %lu k per transfer)\n",
+            depth, memory_with_natural_unit(sizeof(double) * v_len), plan.slabs_per_batch, plan.k_per_tile);
+    
+    for ( item = 0; (item < depth) && (item < n_items); item++ ) async_slot_start(T, &slots[item], &plan, n_k_tiles, item);
+    for ( item = 0; item < n_items; item++ ) {
+        async_slot_t        *S = &slots[item % depth];
+        double              *vt = T->transpose->in_place ? S->v1 : S->v2;
+        
+        async_slot_wait(in_driver, S->reads, &S->n_reads, false);
+        async_slot_wait(out_driver, S->writes, &S->n_writes, true);
+        if ( T->should_write ) {
+            matrix_batch_produce(T, S->v1, vt, S->j, S->j_end, S->k0, S->nk);
+            if ( S->nk == n[2] ) {
+                async_slot_submit(out_driver, &T->out_fh, S->writes, &S->n_writes, (char*)vt, S->xfer_len, sizeof(double) * offset_jik(n, 0, S->j, 0), true);
+            } else {
+                for ( i=0; i<n[0]; i++ ) {
+                    async_slot_submit(out_driver, &T->out_fh, S->writes, &S->n_writes, (char*)(vt + i * S->nk), sizeof(double) * S->nk, sizeof(double) * offset_jik(n, i, S->j, S->k0), true);
+                }
+            }
+        }
+        progress_advance(&T->progress, S->xfer_len);
+        if ( vt == S->v1 ) {
+            S->v1 = S->v2;
+            S->v2 = vt;
+        }
+        if ( item + depth < n_items ) async_slot_start(T, S, &plan, n_k_tiles, item + depth);
+    }
+    for ( s = 0; s < depth; s++ ) async_slot_wait(out_driver, slots[s].writes, &slots[s].n_writes, true);
+    free((void*)req_pool);
+    free((void*)pool);
+}
+
+/*
+ * With n1 == 1 or n3 == 1 every slab is a vector and the jki and jik
+ * layouts are byte-identical, so the output is a copy of the input that the
+ * kernel can make without user-space buffers:  a reflink (FICLONE) where the
+ * filesystem shares extents, else copy_file_range().  Returns false if
+ * neither is possible and the algorithm has to do the work.
+ */
+bool
+transform_copy_degenerate(
+    transform_t             *T
+)
+{
+    unsigned long           *n = T->n;
+    size_t                  l = sizeof(double) * n[0] * n[1] * n[2], done = 0;
+    int                     in_fd, out_fd;
+    struct stat             finfo;
+    loff_t                  off_in = 0, off_out = 0;
+    
+    if ( (n[0] != 1) && (n[2] != 1) ) return false;
+    if ( ! T->in_driver->fileno || ((in_fd = T->in_driver->fileno(&T->in_fh)) < 0) ) return false;
+    if ( ! T->out_driver->fileno || ((out_fd = T->out_driver->fileno(&T->out_fh)) < 0) ) return false;
+    
+#ifdef FICLONE
+    //
+    // A whole-file clone is only right if the input holds exactly the tensor:
+    //
+    if ( (fstat(in_fd, &finfo) == 0) && (finfo.st_size == l) && (ioctl(out_fd, FICLONE, in_fd) == 0) ) {
+        printf("INFO:  jki and jik layouts are identical for n%c = 1, output cloned (FICLONE)\n", (n[0] == 1) ? '1' : '3');
+        progress_advance(&T->progress, l);
+        return true;
+    }
+#endif
+    while ( done < l ) {
+        ssize_t             n_bytes = copy_file_range(in_fd, &off_in, out_fd, &off_out, l - done, 0);
+        
+        if ( n_bytes < 0 ) {
+            if ( errno == EINTR ) continue;
+            if ( done == 0 ) return false;
+            fprintf(stderr, "ERROR:  unable to copy input file to output file at %lu (errno = %d)\n", (unsigned long)done, errno);
+            exit(errno);
+        }
+        if ( n_bytes == 0 ) {
+            fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
+            exit(EINVAL);
+        }
+        done += n_bytes;
+        progress_advance(&T->progress, n_bytes);
+    }
+    printf("INFO:  jki and jik layouts are identical for n%c = 1, output copied in-kernel (copy_file_range)\n", (n[0] == 1) ? '1' : '3');
+    return true;
+}
+
+/*
+ * Allocate the output file's blocks for the whole tensor up front so writes
+ * in any order land in (as far as the filesystem can manage) contiguous
+ * extents:  fallocate(), else posix_fallocate() (which glibc emulates by
+ * touching every block where the filesystem cannot allocate).
+ */
+void
+transform_preallocate_output(
+    transform_t             *T
+)
+{
+    file_handle_callbacks   *out_driver = T->out_driver;
+    unsigned long           *n = T->n;
+    off_t                   l = sizeof(double) * n[0] * n[1] * n[2];
+    int                     out_fd, rc;
+    
+    if ( ! out_driver->fileno || ((out_fd = out_driver->fileno(&T->out_fh)) < 0) ) {
+        printf("WARNING:  output preallocation needs a file descriptor, skipped\n");
+        return;
+    }
+    if ( fallocate(out_fd, 0, 0, l) == 0 ) {
+        printf("INFO:  output preallocated to %s (fallocate)\n", memory_with_natural_unit(l));
+    } else if ( (rc = posix_fallocate(out_fd, 0, l)) == 0 ) {
+        printf("INFO:  output preallocated to %s (posix_fallocate)\n", memory_with_natural_unit(l));
+    } else {
+        printf("WARNING:  unable to preallocate output (errno = %d)\n", rc);
+    }
+}
+
+/*
+ * The number of extents backing the file, from FIEMAP (a query with no
+ * extent array just counts them); -1 if the filesystem cannot say.
+ */
+long
+file_extent_count(
+    const char              *path
+)
+{
+    struct fiemap           fm;
+    int                     fd = open(path, O_RDONLY);
+    long                    n_extents = -1;
+    
+    if ( fd < 0 ) return -1;
+    memset(&fm, 0, sizeof(fm));
+    fm.fm_start = 0;
+    fm.fm_length = FIEMAP_MAX_OFFSET;
+    fm.fm_flags = FIEMAP_FLAG_SYNC;
+    fm.fm_extent_count = 0;
+    if ( ioctl(fd, FS_IOC_FIEMAP, &fm) == 0 ) n_extents = fm.fm_mapped_extents;
+    close(fd);
+    return n_extents;
+}
+
+/*
+ * Pass an access-pattern hint through the driver if --io-hints is on.
+ */
+static inline void
+transform_hint(
+    transform_t             *T,
+    file_handle_callbacks   *driver,
+    file_handle_t           *fh,
+    io_hint_t               hint,
+    off_t                   offset,
+    off_t                   len
+)
+{
+    if ( T->io_hints && driver->hint ) driver->hint(fh, hint, offset, len);
+}
+
+/*
+ * Declare how the algorithm walks each whole file:  in storage order
+ * (sequential) or by strided/scattered elements (random).
+ */
+static void
+transform_hint_patterns(
+    transform_t             *T,
+    algorithm_t             algorithm
+)
+{
+    bool                    in_seq = true, out_seq = true;
+    
+    switch ( algorithm ) {
+        case algorithm_ijk_map:
+            in_seq = out_seq = false;
+            break;
+        case algorithm_jki_map:
+        case algorithm_vector_input:
+            out_seq = false;
+            break;
+        case algorithm_jik_map:
+        case algorithm_vector_output:
+            in_seq = false;
+            break;
+        default:
+            break;
+    }
+    if ( T->should_read ) transform_hint(T, T->in_driver, &T->in_fh, in_seq ? io_hint_sequential : io_hint_random, 0, 0);
+    if ( T->should_write ) transform_hint(T, T->out_driver, &T->out_fh, out_seq ? io_hint_sequential : io_hint_random, 0, 0);
+}
+
+/*
+ * Produce the jik-ordered output file from the jki-ordered input file using
+ * the transform's algorithm.
+ */
+void
+transform_process(
+    transform_t             *T
+)
+{
+    file_handle_callbacks   *in_driver = T->in_driver, *out_driver = T->out_driver;
+    file_handle_t           *in_fh = &T->in_fh, *out_fh = &T->out_fh;
+    unsigned long           *n = T->n, i, j, k;
+    algorithm_t             algorithm = T->algorithm;
+    
+    if ( ! T->no_fast_path && T->should_read && T->should_write && transform_copy_degenerate(T) ) return;
+    if ( T->preallocate && T->should_write ) transform_preallocate_output(T);
+    transform_hint_patterns(T, algorithm);
+    
+    switch ( algorithm ) {
+    
+        case algorithm_invalid:
+        case algorithm_max:
+            break;
+            
+        case algorithm_ijk_map:
+        case algorithm_jki_map:
+        case algorithm_jik_map: {
+            //
+            // The maps differ only in loop order; the iterator carries the
+            // element's input (jki) and output (jik) offsets:
+            //
+            nd_iter_t   I;
+            const char  *order = (algorithm == algorithm_ijk_map) ? "ijk" : ((algorithm == algorithm_jki_map) ? "jki" : "jik");
+            size_t      row_len;
+            
+            if ( ! nd_iter_init(&I, n, NULL, NULL, order, "jki", "jik") ) break;
+            row_len = sizeof(double) * n[I.axis[0]];
+            do {
+                ssize_t     n_bytes;
+                double      v;
+                off_t       fp = sizeof(double) * I.offset[0];
+                
+                i = I.idx[0];
+                j = I.idx[1];
+                k = I.idx[2];
+                if ( I.wrapped ) progress_advance(&T->progress, row_len);
+                if ( T->reorder.capacity ) {
+                    reorder_window_add(&T->reorder, fp, sizeof(double) * I.offset[1]);
+                    continue;
+                }
+                if ( T->should_read ) {
+                    if ( in_driver->seek(in_fh, fp) < 0 ) {
+                        fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) = %lld in input file (errno = %d)\n", i, j, k, fp, errno);
+                        exit(errno);
+                    }
+                    n_bytes = io_transfer_read(in_driver, in_fh, &v, sizeof(v));
+                    if ( n_bytes != sizeof(v) ) {
+                        if ( n_bytes >= 0 ) {
+                            fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
+                            exit(EINVAL);
+                        }
+                        fprintf(stderr, "ERROR:  unable to read (%lu, %lu, %lu) from input file (errno = %d)\n", i, j, k, errno);
+                        exit(errno);
+                    }
+                } else {
+                    v = I.offset[0];
+                }
+                if ( T->should_write ) {
+                    fp = sizeof(double) * I.offset[1];
+                    if ( out_driver->seek(out_fh, fp) < 0 ) {
+                        fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) in output file (errno = %d)\n", i, j, k, errno);
+                        exit(errno);
+                    }
+                    n_bytes = io_transfer_write(out_driver, out_fh, &v, sizeof(v));
+                    if ( n_bytes != sizeof(v) ) {
+                        fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to output file (errno = %d)\n", i, j, k, errno);
+                        exit(errno);
+                    }
+                }
+            } while ( nd_iter_next(&I) );
+            progress_advance(&T->progress, row_len);
+            break;
+        }
+        
+        case algorithm_vector_input: {
+            size_t      v_len = sizeof(double) * n[0];
+            double      *v = (double*)malloc(v_len);
+                    
+            if ( ! v ) {
+                fprintf(stderr, "ERROR:  unable to allocate read vector in vector_input\n");
+                exit(ENOMEM);
+            }
+            printf("INFO:  read vector of size %s allocated\n", memory_with_natural_unit(v_len));
+            
+            for ( j=0; j<n[1]; j++ ) {
+                for ( k=0; k<n[2]; k++ ) {
+                    ssize_t     n_bytes;
+                    off_t       fp = sizeof(double) * offset_jki(n, 0, j, k);
+                    
+                    if ( T->should_read ) {
+                        if ( in_driver->seek(in_fh, fp) < 0 ) {
+                            fprintf(stderr, "ERROR:  unable to seek to (..., %lu, %lu) = %lld in input file (errno = %d)\n", j, k, fp, errno);
+                            exit(errno);
+                        }
+                        n_bytes = io_transfer_read(in_driver, in_fh, v, v_len);
+                        if ( n_bytes != v_len ) {
+                            if ( n_bytes >= 0 ) {
+                                fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
+                                exit(EINVAL);
+                            }
+                            fprintf(stderr, "ERROR:  unable to read (..., %lu, %lu) from input file (errno = %d)\n", j, k, errno);
+                            exit(errno);
+                        }
+                    } else {
+                        unsigned long   base = offset_jki(n, 0, j, k);
+                        
+                        for ( i=0; i<n[0]; i++ ) v[i] = base + i;
+                    }
+                    if ( T->should_write ) {
+                        off_t           fp_step = sizeof(double) * n[2];
+                        
+                        fp = sizeof(double) * offset_jik(n, 0, j, k);
+                        for ( i=0; i<n[0]; i++, fp += fp_step ) {
+                            if ( out_driver->seek(out_fh, fp) < 0 ) {
+                                fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) in output file (errno = %d)\n", i, j, k, errno);
+                                exit(errno);
+                            }
+                            n_bytes = io_transfer_write(out_driver, out_fh, v + i, sizeof(double));
+                            if ( n_bytes != sizeof(double) ) {
+                                fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to output file (errno = %d)\n", i, j, k, errno);
+                                exit(errno);
+                            }
+                        }
+                    }
+                    progress_advance(&T->progress, v_len);
+                }
+            }
+            free((void*)v);
+            break;
+        }
+        
+        case algorithm_vector_output: {
+            size_t      v_len = sizeof(double) * n[2];
+            double      *v = (double*)malloc(v_len);
+                    
+            if ( ! v ) {
+                fprintf(stderr, "ERROR:  unable to allocate write vector in vector_output\n");
+                exit(ENOMEM);
+            }
+            printf("INFO:  write vector of size %s allocated\n", memory_with_natural_unit(v_len));
+            
+            for ( j=0; j<n[1]; j++ ) {
+                for ( i=0; i<n[0]; i++ ) {
+                    off_t           fp;
+                    ssize_t         n_bytes;
+                    unsigned long   e = offset_jki(n, i, j, 0);
+                    
+                    for ( k=0; k<n[2]; k++, e += n[0] ) {
+                        if ( ! T->should_read ) {
+                            v[k] = e;
+                            continue;
+                        }
+                        fp = sizeof(double) * e;
+                        if ( in_driver->seek(in_fh, fp) < 0 ) {
+                            fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) = %lld in input file (errno = %d)\n", i, j, k, fp, errno);
+                            exit(errno);
+                        }
+                        n_bytes = io_transfer_read(in_driver, in_fh, v + k, sizeof(double));
+                        if ( n_bytes != sizeof(double) ) {
+                            if ( n_bytes >= 0 ) {
+                                fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
+                                exit(EINVAL);
+                            }
+                            fprintf(stderr, "ERROR:  unable to read (%lu, %lu, %lu) from input file (errno = %d)\n", i, j, k, errno);
+                            exit(errno);
+                        }
+                    }
+                    if ( ! T->should_write ) {
+                        progress_advance(&T->progress, v_len);
+                        continue;
+                    }
+                    
+                    fp = sizeof(double) * offset_jik(n, i, j, 0);
+                    
+                    if ( out_driver->seek(out_fh, fp) < 0 ) {
+                        fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, ...) in output file (errno = %d)\n", i, j, errno);
+                        exit(errno);
+                    }
+                    n_bytes = io_transfer_write(out_driver, out_fh, v, v_len);
+                    if ( n_bytes != v_len ) {
+                        fprintf(stderr, "ERROR:  unable to write (%lu, %lu, ...) to output file (errno = %d)\n", i, j, errno);
+                        exit(errno);
+                    }
+                    progress_advance(&T->progress, v_len);
+                }
+            }
+            free((void*)v);
+            break;
+        }
+        
+        case algorithm_matrix_async:
+            matrix_async_process(T);
+            break;
+        
+        case algorithm_matrix_uring:
+            if ( matrix_uring_process(T) ) break;
+            printf("WARNING:  io_uring unavailable, algorithm 'matrix' used instead\n");
+            // Fall through to matrix...
+        
+        case algorithm_matrix: {
+            matrix_plan_t   plan;
+            size_t          v_len;
+            double          *v1, *v2, *vt;
+            unsigned long   j_end, k0, k_end;
+            off_t           out_drop_from = 0;
+            
+            if ( ! matrix_plan_for_budget(n, T->mem_budget, 2, &plan) ) {
+                fprintf(stderr, "ERROR:  memory budget too small for read+write matrices in matrix\n");
+                exit(ENOMEM);
+            }
+            T->plan = plan;
+            v_len = sizeof(double) * plan.slabs_per_batch * n[0] * plan.k_per_tile;
+            v1 = (double*)malloc(2 * v_len);
+            if ( ! v1 ) {
+                fprintf(stderr, "ERROR:  unable to allocate read+write matrices in matrix\n");
+                exit(ENOMEM);
+            }
+            printf("INFO:  read+write matrices of size 2 x %s allocated (%lu slab(s) x %lu k per transfer)\n",
+                    memory_with_natural_unit(v_len), plan.slabs_per_batch, plan.k_per_tile);
+            v2 = v1 + plan.slabs_per_batch * n[0] * plan.k_per_tile;
+            
+            //
+            // An in-place kernel leaves the transposed slabs in the read buffer:
+            //
+            vt = T->transpose->in_place ? v1 : v2;
+            
+            for ( j=0; j<n[1]; j = j_end ) {
+                j_end = j + plan.slabs_per_batch;
+                if ( j_end > n[1] ) j_end = n[1];
+                
+                for ( k0=0; k0<n[2]; k0 = k_end ) {
+                    ssize_t         n_bytes;
+                    off_t           fp = sizeof(double) * offset_jki(n, 0, j, k0);
+                    unsigned long   jj, nk, slab_len;
+                    size_t          xfer_len;
+                    struct timespec t0;
+                    
+                    k_end = k0 + plan.k_per_tile;
+                    if ( k_end > n[2] ) k_end = n[2];
+                    nk = k_end - k0;
+                    slab_len = n[0] * nk;
+                    xfer_len = sizeof(double) * (j_end - j) * slab_len;
+                    
+                    if ( T->should_read ) {
+                        //
+                        // The input is consumed in storage order, so the next
+                        // transfer follows this one:
+                        //
+                        transform_hint(T, in_driver, in_fh, io_hint_will_need, fp + xfer_len, xfer_len);
+                        if ( in_driver->seek(in_fh, fp) < 0 ) {
+                            fprintf(stderr, "ERROR:  unable to seek to (..., %lu, %lu) = %lld in input file (errno = %d)\n", j, k0, fp, errno);
+                            exit(errno);
+                        }
+                        n_bytes = io_transfer_read(in_driver, in_fh, v1, xfer_len);
+                        if ( n_bytes != xfer_len ) {
+                            if ( n_bytes >= 0 ) {
+                                fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
+                                exit(EINVAL);
+                            }
+                            fprintf(stderr, "ERROR:  unable to read (..., %lu, %lu) from input file (errno = %d)\n", j, k0, errno);
+                            exit(errno);
+                        }
+                        transform_hint(T, in_driver, in_fh, io_hint_dont_need, fp, xfer_len);
+                        if ( ! T->should_write ) {
+                            progress_advance(&T->progress, xfer_len);
+                            continue;
+                        }
+                        clock_gettime(CLOCK_MONOTONIC, &t0);
+                        for ( jj=0; jj<(j_end - j); jj++ ) {
+                            T->transpose->fn(v1 + jj * slab_len, vt + jj * slab_len, n[0], nk);
+                        }
+                        T->transpose_seconds += transform_seconds_since(&t0);
+                        T->transpose_bytes += 2 * xfer_len;
+                    } else {
+                        //
+                        // Synthesize the transposed data the input would have held:
+                        //
+                        unsigned long   lo[3] = { 0, j, k0 }, hi[3] = { n[0], j_end, k0 + nk };
+                        
+                        nd_fill_offsets(vt, n, lo, hi, "jik", "jki");
+                    }
+                    if ( nk == n[2] ) {
+                        //
+                        // Whole slabs are contiguous in the output, too:
+                        //
+                        fp = sizeof(double) * offset_jik(n, 0, j, 0);
+                        if ( out_driver->seek(out_fh, fp) < 0 ) {
+                            fprintf(stderr, "ERROR:  unable to seek to (..., %lu, ...) in output file (errno = %d)\n", j, errno);
+                            exit(errno);
+                        }
+                        n_bytes = io_transfer_write(out_driver, out_fh, vt, xfer_len);
+                        if ( n_bytes != xfer_len ) {
+                            fprintf(stderr, "ERROR:  unable to write (..., %lu, ...) to output file (errno = %d)\n", j, errno);
+                            exit(errno);
+                        }
+                    } else {
+                        //
+                        // A k tile is n1 separate runs of nk words in the output:
+                        //
+                        for ( i=0; i<n[0]; i++ ) {
+                            fp = sizeof(double) * offset_jik(n, i, j, k0);
+                            if ( out_driver->seek(out_fh, fp) < 0 ) {
+                                fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) in output file (errno = %d)\n", i, j, k0, errno);
+                                exit(errno);
+                            }
+                            n_bytes = io_transfer_write(out_driver, out_fh, vt + i * nk, sizeof(double) * nk);
+                            if ( n_bytes != sizeof(double) * nk ) {
+                                fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to output file (errno = %d)\n", i, j, k0, errno);
+                                exit(errno);
+                            }
+                        }
+                    }
+                    if ( k_end == n[2] ) {
+                        //
+                        // The batch's output is complete:  start its writeback
+                        // and drop the previous batch, whose writeback was
+                        // started last time around:
+                        //
+                        transform_hint(T, out_driver, out_fh, io_hint_dont_need, out_drop_from, sizeof(double) * offset_jik(n, 0, j_end, 0) - out_drop_from);
+                        out_drop_from = sizeof(double) * offset_jik(n, 0, j, 0);
+                    }
+                    progress_advance(&T->progress, xfer_len);
+                }
+            }
+            free((void*)v1);
+            break;
+        }
+        
+        case algorithm_matrix_parallel: {
+            matrix_parallel_t   M;
+            int                 n_threads = (T->n_threads > 0) ? T->n_threads : 1, t;
+            pthread_t           threads[n_threads];
+            unsigned long       max_slabs;
+            
+            if ( (! in_driver->clone && ! in_driver->pread) || (! out_driver->clone && ! out_driver->pwrite) ) {
+                fprintf(stderr, "ERROR:  algorithm matrix_parallel requires drivers with positional i/o or handle cloning\n");
+                exit(EINVAL);
+            }
+            //
+            // Each thread holds two buffers; keep at least four work items
+            // per thread so the last ones to finish do not idle the rest:
+            //
+            if ( ! matrix_plan_for_budget(n, T->mem_budget / n_threads, 2, &M.plan) ) {
+                fprintf(stderr, "ERROR:  memory budget too small for %d x read+write matrices in matrix_parallel\n", n_threads);
+                exit(ENOMEM);
+            }
+            max_slabs = (n[1] + 4 * n_threads - 1) / (4 * n_threads);
+            if ( M.plan.slabs_per_batch > max_slabs ) M.plan.slabs_per_batch = max_slabs;
+            T->plan = M.plan;
+            M.T = T;
+            M.n_k_tiles = (n[2] + M.plan.k_per_tile - 1) / M.plan.k_per_tile;
+            M.n_items = ((n[1] + M.plan.slabs_per_batch - 1) / M.plan.slabs_per_batch) * M.n_k_tiles;
+            M.next_item = 0;
+            pthread_mutex_init(&M.lock, NULL);
+            printf("INFO:  %d thread(s) with read+write matrices of size 2 x %s each (%lu slab(s) x %lu k per transfer)\n",
+                    n_threads, memory_with_natural_unit(sizeof(double) * M.plan.slabs_per_batch * n[0] * M.plan.k_per_tile),
+                    M.plan.slabs_per_batch, M.plan.k_per_tile);
+            
+            for ( t = 1; t < n_threads; t++ ) {
+                int             prc = pthread_create(&threads[t], NULL, matrix_parallel_worker, &M);
+                
+                if ( prc != 0 ) {
+                    fprintf(stderr, "WARNING:  only %d of %d matrix_parallel threads started (errno = %d)\n", t, n_threads, prc);
+                    n_threads = t;
+                    break;
+                }
+            }
+            matrix_parallel_worker(&M);
+            for ( t = 1; t < n_threads; t++ ) pthread_join(threads[t], NULL);
+            pthread_mutex_destroy(&M.lock);
+            break;
+        }
+    
+    }
+}
+
+//
+
+typedef struct {
+    bool                    has_io;
+    unsigned long long      rchar, wchar, syscr, syscw, read_bytes, write_bytes;
+    struct rusage           usage;
+} resource_snapshot_t;
+
+void
+resource_snapshot_take(
+    resource_snapshot_t     *S
+)
+{
+    FILE                    *fptr = fopen("/proc/self/io", "r");
+    
+    memset(S, 0, sizeof(*S));
+    if ( fptr ) {
+        char                line[128];
+        int                 n_found = 0;
+        
+        while ( fgets(line, sizeof(line), fptr) ) {
+            if ( sscanf(line, "rchar: %llu", &S->rchar) == 1 ) n_found++;
+            else if ( sscanf(line, "wchar: %llu", &S->wchar) == 1 ) n_found++;
+            else if ( sscanf(line, "syscr: %llu", &S->syscr) == 1 ) n_found++;
+            else if ( sscanf(line, "syscw: %llu", &S->syscw) == 1 ) n_found++;
+            else if ( sscanf(line, "read_bytes: %llu", &S->read_bytes) == 1 ) n_found++;
+            else if ( sscanf(line, "write_bytes: %llu", &S->write_bytes) == 1 ) n_found++;
+        }
+        fclose(fptr);
+        S->has_io = (n_found == 6) ? true : false;
+    }
+    getrusage(RUSAGE_SELF, &S->usage);
+}
+
+static double
+resource_ratio(
+    double                  num,
+    double                  denom
+)
+{
+    return (denom > 0.0) ? (num / denom) : 0.0;
+}
+
+/*
+ * Report the change in i/o counters and resource usage over a phase, and the
+ * amplification relative to the logical data movement:  device bytes per
+ * logical byte (read_bytes and write_bytes count storage traffic, rchar and
+ * wchar everything passed through read/write-like calls) and system calls
+ * per tensor element.
+ */
 void
-usage(
-    const char  *exe
+resource_report(
+    const char              *phase,
+    resource_snapshot_t     *before,
+    resource_snapshot_t     *after,
+    size_t                  logical_read,
+    size_t                  logical_write,
+    unsigned long           n_elements
 )
 {
-    printf(
-            "usage:\n\n"
-            "    %s {options}\n\n"
-            "  options:\n\n"
-            "    -h/--help                    show this information\n"
-            "    -1 #, --n1=#                 range of index i\n"
-            "    -2 #, --n2=#                 range of index j\n"
-            "    -3 #, --n3=#                 range of index k\n"
-            "    -i <filepath>,               read (or possibly init) this file\n"
-            "        --input=<filepath>         as the source\n"
-            "    -o <filepath>,               write this file as the destination\n"
-            "        --output=<filepath>\n"
-            "    -x, --exact-dims             file sizes must exactly match the\n"
-            "                                   n1/n2/n3 dimensions\n"
-            "    -a <algorithm>,              use this specific i/o algorithm\n"
-            "        --algorithm=<algorithm>    in the input init and file processing\n"
-            "    -d <driver>,                 use this specific i/o driver for all\n"
-            "        --driver=<driver>          file access\n"
-            "    -I, --init-input             generate newly-initialized data in\n"
-            "                                   in the input file\n\n"
-            "  <algorithm>:\n"
-            "    jki_map         iterates in sequence j, k, i, reading from input\n"
-            "                    then writing to output (this is the default)\n" 
-            "    jik_map         iterates in sequence j, i, k, reading from input\n"
-            "                    then writing to output\n"
-            "    ijk_map         iterates in sequence i, j, k, reading from input\n"
-            "                    then writing to output\n"
-            "    vector_input    1xn1 chunks are read from input then mapped by\n"
-            "                    index iteration to the output (requires n3 words of\n"
-            "                    memory)\n"
-            "    vector_output   1xn3 chunks are mapped by index iteration from the\n"
-            "                    input then written to the output (requires n3 words\n"
-            "                    of memory)\n"
-            "    matrix          n1xn3 chunks are read from input then transposed\n"
-            "                    in memory and written en masse to the output\n"
-            "                    (requires 2 x n1 x n3 words of memory)\n\n"
-            "  <driver>:\n"
-            "    fd              Unix file descriptor - open/lseek/read/write/close\n"
-            "                    (this is the default)\n"
-            "    stream          C file stream - fopen/fseeko/fread/fwrite/fclose\n"
-            "\n",
-            exe);
+    if ( before->has_io && after->has_io ) {
+        unsigned long long  rchar = after->rchar - before->rchar,
+                            wchar = after->wchar - before->wchar,
+                            syscr = after->syscr - before->syscr,
+                            syscw = after->syscw - before->syscw,
+                            read_bytes = after->read_bytes - before->read_bytes,
+                            write_bytes = after->write_bytes - before->write_bytes;
+        
+        printf("INFO:  %s i/o:  rchar %llu, wchar %llu, read_bytes %llu, write_bytes %llu, syscr %llu, syscw %llu\n",
+                phase, rchar, wchar, read_bytes, write_bytes, syscr, syscw);
+        printf("INFO:  %s amplification:  device/logical read %.4lf, device/logical write %.4lf, "
+               "rchar/logical read %.4lf, wchar/logical write %.4lf, syscalls/element %.4lf\n",
+                phase,
+                resource_ratio(read_bytes, logical_read), resource_ratio(write_bytes, logical_write),
+                resource_ratio(rchar, logical_read), resource_ratio(wchar, logical_write),
+                resource_ratio(syscr + syscw, n_elements));
+    } else {
+        printf("WARNING:  %s i/o counters unavailable (no /proc/self/io)\n", phase);
+    }
+    printf("INFO:  %s rusage:  minor faults %ld, major faults %ld, voluntary ctx sw %ld, involuntary ctx sw %ld, max RSS %s\n",
+            phase,
+            after->usage.ru_minflt - before->usage.ru_minflt,
+            after->usage.ru_majflt - before->usage.ru_majflt,
+            after->usage.ru_nvcsw - before->usage.ru_nvcsw,
+            after->usage.ru_nivcsw - before->usage.ru_nivcsw,
+            memory_with_natural_unit((size_t)after->usage.ru_maxrss * 1024));
 }
 
 //
 
-unsigned long
-offset_ijk(
-    unsigned long   *n,
-    unsigned long   i,
-    unsigned long   j,
-    unsigned long   k
+void
+stats_mean_stddev(
+    double                  *x,
+    int                     n,
+    double                  *mean,
+    double                  *stddev
 )
 {
-    return i * n[2] * n[1] + n[2] * j + k;
+    double                  sum = 0.0, sum2 = 0.0;
+    int                     i;
+    
+    for ( i = 0; i < n; i++ ) sum += x[i];
+    *mean = (n > 0) ? (sum / n) : 0.0;
+    for ( i = 0; i < n; i++ ) sum2 += (x[i] - *mean) * (x[i] - *mean);
+    *stddev = (n > 1) ? sqrt(sum2 / (n - 1)) : 0.0;
+}
+
+/*
+ * Continued fraction for the regularized incomplete beta function (modified
+ * Lentz's method).
+ */
+static double
+stats_betacf(
+    double                  a,
+    double                  b,
+    double                  x
+)
+{
+    double                  c = 1.0, d = 1.0 - (a + b) * x / (a + 1.0), h;
+    int                     m;
+    
+    if ( fabs(d) < 1e-300 ) d = 1e-300;
+    d = 1.0 / d;
+    h = d;
+    for ( m = 1; m <= 300; m++ ) {
+        double              aa = m * (b - m) * x / ((a + 2.0 * m - 1.0) * (a + 2.0 * m)), del;
+        
+        d = 1.0 + aa * d;
+        if ( fabs(d) < 1e-300 ) d = 1e-300;
+        c = 1.0 + aa / c;
+        if ( fabs(c) < 1e-300 ) c = 1e-300;
+        d = 1.0 / d;
+        h *= d * c;
+        aa = -(a + m) * (a + b + m) * x / ((a + 2.0 * m) * (a + 2.0 * m + 1.0));
+        d = 1.0 + aa * d;
+        if ( fabs(d) < 1e-300 ) d = 1e-300;
+        c = 1.0 + aa / c;
+        if ( fabs(c) < 1e-300 ) c = 1e-300;
+        d = 1.0 / d;
+        del = d * c;
+        h *= del;
+        if ( fabs(del - 1.0) < 1e-12 ) break;
+    }
+    return h;
+}
+
+static double
+stats_incbeta(
+    double                  a,
+    double                  b,
+    double                  x
+)
+{
+    double                  bt;
+    
+    if ( x <= 0.0 ) return 0.0;
+    if ( x >= 1.0 ) return 1.0;
+    bt = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1.0 - x));
+    if ( x < (a + 1.0) / (a + b + 2.0) ) return bt * stats_betacf(a, b, x) / a;
+    return 1.0 - bt * stats_betacf(b, a, 1.0 - x) / b;
+}
+
+/*
+ * One-sided Welch's t-test:  the probability of seeing a difference at least
+ * this large if the mean of y were not greater than the mean of x.
+ */
+double
+stats_welch_p_greater(
+    double                  *x,
+    int                     nx,
+    double                  *y,
+    int                     ny
+)
+{
+    double                  mx, sx, my, sy, vx, vy, t, df, p;
+    
+    stats_mean_stddev(x, nx, &mx, &sx);
+    stats_mean_stddev(y, ny, &my, &sy);
+    vx = sx * sx / nx;
+    vy = sy * sy / ny;
+    if ( vx + vy <= 0.0 ) return (my > mx) ? 0.0 : 1.0;
+    t = (my - mx) / sqrt(vx + vy);
+    df = (vx + vy) * (vx + vy) / ((vx * vx) / (nx - 1) + (vy * vy) / (ny - 1));
+    p = 0.5 * stats_incbeta(0.5 * df, 0.5, df / (df + t * t));
+    return (t > 0.0) ? p : (1.0 - p);
 }
 
 //
 
-unsigned long
-offset_jki(
-    unsigned long   *n,
-    unsigned long   i,
-    unsigned long   j,
-    unsigned long   k
+/*
+ * A baseline file holds one line per benchmark configuration:  the
+ * configuration key, a tab, the sample count, a tab, and the space-separated
+ * elapsed times in seconds.
+ */
+#define BASELINE_MAX_SAMPLES            1024
+#define BASELINE_DEFAULT_THRESHOLD      5.0
+#define BASELINE_DEFAULT_SIGNIFICANCE   0.05
+#define BASELINE_REGRESSION_EXIT_STATUS 3
+
+typedef struct {
+    const char              *dir;
+    const char              *save_name, *compare_name;
+    double                  threshold, significance;
+} baseline_config_t;
+
+static char*
+baseline_path(
+    baseline_config_t       *cfg,
+    const char              *name
 )
 {
-    return j * n[0] * n[2] + n[0] * k + i;
+    char                    *path = malloc(strlen(cfg->dir) + strlen(name) + 16);
+    
+    if ( path ) sprintf(path, "%s/%s.baseline", cfg->dir, name);
+    return path;
+}
+
+int
+baseline_load(
+    const char              *path,
+    const char              *key,
+    double                  *samples
+)
+{
+    FILE                    *fptr = fopen(path, "r");
+    char                    *line = NULL;
+    size_t                  line_len = 0, key_len = strlen(key);
+    int                     n = -1;
+    
+    if ( ! fptr ) return -1;
+    while ( getline(&line, &line_len, fptr) > 0 ) {
+        if ( (strncmp(line, key, key_len) == 0) && (line[key_len] == '\t') ) {
+            char            *p = line + key_len + 1, *eos;
+            int             i, count = strtol(p, &eos, 10);
+            
+            if ( (eos == p) || (count < 1) || (count > BASELINE_MAX_SAMPLES) ) break;
+            for ( i = 0, p = eos; i < count; i++, p = eos ) {
+                samples[i] = strtod(p, &eos);
+                if ( eos == p ) break;
+            }
+            if ( i == count ) n = count;
+            break;
+        }
+    }
+    free(line);
+    fclose(fptr);
+    return n;
+}
+
+bool
+baseline_save(
+    const char              *path,
+    const char              *key,
+    double                  *samples,
+    int                     n_samples
+)
+{
+    FILE                    *in_fptr = fopen(path, "r"), *out_fptr;
+    char                    *tmp_path = malloc(strlen(path) + 8), *line = NULL;
+    size_t                  line_len = 0, key_len = strlen(key);
+    int                     i;
+    
+    if ( ! tmp_path ) return false;
+    sprintf(tmp_path, "%s.new", path);
+    if ( ! (out_fptr = fopen(tmp_path, "w")) ) {
+        if ( in_fptr ) fclose(in_fptr);
+        free(tmp_path);
+        return false;
+    }
+    //
+    // Keep every other configuration's line:
+    //
+    if ( in_fptr ) {
+        while ( getline(&line, &line_len, in_fptr) > 0 ) {
+            if ( (strncmp(line, key, key_len) == 0) && (line[key_len] == '\t') ) continue;
+            fputs(line, out_fptr);
+        }
+        free(line);
+        fclose(in_fptr);
+    }
+    fprintf(out_fptr, "%s\t%d\t", key, n_samples);
+    for ( i = 0; i < n_samples; i++ ) fprintf(out_fptr, "%s%.9lf", i ? " " : "", samples[i]);
+    fprintf(out_fptr, "\n");
+    if ( (fclose(out_fptr) != 0) || (rename(tmp_path, path) != 0) ) {
+        free(tmp_path);
+        return false;
+    }
+    free(tmp_path);
+    return true;
+}
+
+/*
+ * Compare the samples against the named baseline's samples for the same
+ * configuration.  A regression is a mean slower by more than the threshold
+ * percentage that is also significant under a one-sided Welch's t-test (when
+ * either side has a single sample no test is possible, and the threshold
+ * alone decides).  Returns true on regression.
+ */
+bool
+baseline_compare(
+    baseline_config_t       *cfg,
+    const char              *key,
+    double                  *samples,
+    int                     n_samples
+)
+{
+    char                    *path = baseline_path(cfg, cfg->compare_name);
+    double                  base[BASELINE_MAX_SAMPLES], base_mean, base_sd, mean, sd, change, p = 0.0;
+    int                     n_base;
+    bool                    is_regression;
+    
+    if ( ! path || ((n_base = baseline_load(path, key, base)) < 1) ) {
+        printf("WARNING:  baseline '%s' has no entry for configuration: %s\n", cfg->compare_name, key);
+        free(path);
+        return false;
+    }
+    free(path);
+    stats_mean_stddev(base, n_base, &base_mean, &base_sd);
+    stats_mean_stddev(samples, n_samples, &mean, &sd);
+    change = 100.0 * (mean - base_mean) / base_mean;
+    if ( (n_base > 1) && (n_samples > 1) ) {
+        p = stats_welch_p_greater(base, n_base, samples, n_samples);
+        is_regression = ((change > cfg->threshold) && (p < cfg->significance)) ? true : false;
+        printf("INFO:  baseline '%s':  %.6lf +/- %.6lf s (n=%d) vs. %.6lf +/- %.6lf s (n=%d), %+.2lf%%, p = %.4lf\n",
+                cfg->compare_name, base_mean, base_sd, n_base, mean, sd, n_samples, change, p);
+    } else {
+        is_regression = (change > cfg->threshold) ? true : false;
+        printf("INFO:  baseline '%s':  %.6lf s (n=%d) vs. %.6lf s (n=%d), %+.2lf%% (too few samples for a significance test)\n",
+                cfg->compare_name, base_mean, n_base, mean, n_samples, change);
+    }
+    if ( is_regression ) {
+        printf("ERROR:  performance regression against baseline '%s' (threshold %.2lf%%): %s\n", cfg->compare_name, cfg->threshold, key);
+    }
+    return is_regression;
 }
 
 //
 
-unsigned long
-offset_jik(
-    unsigned long   *n,
-    unsigned long   i,
-    unsigned long   j,
-    unsigned long   k
+/*
+ * A thread-scaling study runs the processing at 1, 2, 4, ... threads up to
+ * the number of usable CPUs, optionally once per NUMA node with the process
+ * pinned to that node's CPUs.
+ */
+#define SCALING_MAX_RUNS            256
+
+/*
+ * Throughput has saturated once doubling the threads gains less than this:
+ */
+#define SCALING_SATURATION_GAIN     1.10
+
+typedef struct {
+    int             node;
+    int             n_threads;
+    double          dt;
+} scaling_run_t;
+
+/*
+ * Parse a sysfs cpulist ("0-3,8,10-11") into a CPU set.
+ */
+bool
+scaling_node_cpus(
+    int             node,
+    cpu_set_t       *cpus
 )
 {
-    return j * n[0] * n[2] + n[2] * i + k;
+    char            path[64], line[4096], *p;
+    FILE            *fptr;
+    
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    if ( ! (fptr = fopen(path, "r")) ) return false;
+    p = fgets(line, sizeof(line), fptr);
+    fclose(fptr);
+    if ( ! p ) return false;
+    CPU_ZERO(cpus);
+    while ( *p && (*p != '\n') ) {
+        char        *eos;
+        long        lo = strtol(p, &eos, 10), hi = lo;
+        
+        if ( eos == p ) return false;
+        if ( *eos == '-' ) {
+            p = eos + 1;
+            hi = strtol(p, &eos, 10);
+            if ( eos == p ) return false;
+        }
+        while ( (lo <= hi) && (lo < CPU_SETSIZE) ) CPU_SET(lo++, cpus);
+        p = (*eos == ',') ? eos + 1 : eos;
+    }
+    return true;
+}
+
+/*
+ * Append the runs for one CPU set:  powers of two up to, and always ending
+ * with, the number of CPUs in the set.
+ */
+static int
+scaling_add_runs(
+    scaling_run_t   *runs,
+    int             n_runs,
+    int             node,
+    int             n_cpus
+)
+{
+    int             t;
+    
+    for ( t = 1; (t < n_cpus) && (n_runs < SCALING_MAX_RUNS); t *= 2 ) runs[n_runs++] = (scaling_run_t){ node, t, 0.0 };
+    if ( n_runs < SCALING_MAX_RUNS ) runs[n_runs++] = (scaling_run_t){ node, n_cpus, 0.0 };
+    return n_runs;
+}
+
+/*
+ * Fill in the study's runs; node is -1 for the runs that use all of the
+ * process's allowed CPUs.  Returns the number of runs.
+ */
+int
+scaling_plan(
+    scaling_run_t   *runs,
+    bool            per_node
+)
+{
+    cpu_set_t       allowed;
+    int             n_runs = 0, node;
+    
+    if ( sched_getaffinity(0, sizeof(allowed), &allowed) != 0 ) {
+        CPU_ZERO(&allowed);
+        for ( node = 0; node < sysconf(_SC_NPROCESSORS_ONLN) && node < CPU_SETSIZE; node++ ) CPU_SET(node, &allowed);
+    }
+    n_runs = scaling_add_runs(runs, n_runs, -1, CPU_COUNT(&allowed));
+    if ( per_node ) {
+        cpu_set_t   cpus;
+        
+        for ( node = 0; scaling_node_cpus(node, &cpus); node++ ) {
+            CPU_AND(&cpus, &cpus, &allowed);
+            if ( CPU_COUNT(&cpus) > 0 ) n_runs = scaling_add_runs(runs, n_runs, node, CPU_COUNT(&cpus));
+        }
+        if ( node == 0 ) printf("WARNING:  no NUMA nodes found in /sys/devices/system/node, per-node runs skipped\n");
+    }
+    return n_runs;
+}
+
+/*
+ * Pin the process (and the threads it creates from now on) to a node's
+ * CPUs, or restore the original CPU set for node -1.
+ */
+void
+scaling_pin(
+    int             node
+)
+{
+    static cpu_set_t    original;
+    static bool         have_original = false;
+    cpu_set_t           cpus;
+    
+    if ( ! have_original ) {
+        if ( sched_getaffinity(0, sizeof(original), &original) != 0 ) return;
+        have_original = true;
+    }
+    if ( node < 0 ) {
+        cpus = original;
+    } else {
+        if ( ! scaling_node_cpus(node, &cpus) ) return;
+        CPU_AND(&cpus, &cpus, &original);
+    }
+    if ( sched_setaffinity(0, sizeof(cpus), &cpus) != 0 ) {
+        printf("WARNING:  unable to pin to NUMA node %d (errno = %d)\n", node, errno);
+    }
+}
+
+/*
+ * Print speedup and parallel efficiency relative to each group's 1-thread
+ * run, and the thread count past which throughput stops improving.
+ */
+void
+scaling_report(
+    scaling_run_t   *runs,
+    int             n_runs,
+    size_t          bytes
+)
+{
+    int             r0 = 0, r;
+    
+    while ( r0 < n_runs ) {
+        int         r_end = r0, saturated_at = -1;
+        double      t1 = runs[r0].dt;
+        
+        while ( (r_end < n_runs) && (runs[r_end].node == runs[r0].node) ) r_end++;
+        if ( runs[r0].node < 0 ) {
+            printf("INFO:  thread scaling, all allowed CPUs:\n");
+        } else {
+            printf("INFO:  thread scaling, pinned to NUMA node %d:\n", runs[r0].node);
+        }
+        printf("INFO:      threads        time (s)          MiB/s   speedup  efficiency\n");
+        for ( r = r0; r < r_end; r++ ) {
+            double  speedup = t1 / runs[r].dt;
+            
+            printf("INFO:      %7d  %14.6lf  %13.2lf  %8.2lf  %9.1lf%%\n",
+                    runs[r].n_threads, runs[r].dt, bytes / runs[r].dt / (1024.0 * 1024.0),
+                    speedup, 100.0 * speedup / runs[r].n_threads);
+            if ( (saturated_at < 0) && (r > r0) && (runs[r - 1].dt / runs[r].dt < SCALING_SATURATION_GAIN) ) saturated_at = r - 1;
+        }
+        if ( saturated_at >= 0 ) {
+            printf("INFO:  throughput saturates at %d thread(s), %.2lf MiB/s (more threads gain < %.0lf%%)\n",
+                    runs[saturated_at].n_threads, bytes / runs[saturated_at].dt / (1024.0 * 1024.0),
+                    100.0 * (SCALING_SATURATION_GAIN - 1.0));
+        } else {
+            printf("INFO:  throughput did not saturate up to %d thread(s)\n", runs[r_end - 1].n_threads);
+        }
+        r0 = r_end;
+    }
 }
 
 //
 
-const char*
-memory_with_natural_unit(
-    size_t  bytes
+typedef struct {
+    algorithm_t             algorithm;
+    unsigned long           n[3];
+} tenant_spec_t;
+
+typedef struct {
+    int                     tenant_idx;
+    pid_t                   pid;
+    int                     rc;
+    size_t                  bytes;
+    double                  init_time;
+    struct timespec         start, end;
+} tenant_result_t;
+
+#define TENANT_MAX_SPECS    64
+
+#define DRIVER_OPT_MAX_COUNT    32
+
+/*
+ * When running as one of several concurrent tenants, the child's result is
+ * written to this descriptor just before it exits.
+ */
+static int tenant_result_fd = -1;
+static tenant_result_t tenant_result;
+
+bool
+string_to_tenant_spec(
+    const char              *s,
+    tenant_spec_t           *spec
 )
 {
-    static char*    prefix[] = {
-                            "",
-                            "Ki",
-                            "Mi",
-                            "Gi",
-                            "Ti",
-                            "Pi"
-                        };
-    static char     memstr[256];
-    int             prefix_idx = 0, prefix_max = (sizeof(prefix) / sizeof(char*)) - 1;
-    double          value = (double)bytes;
+    const char              *colon = strchr(s, ':');
+    char                    alg_name[64];
+    size_t                  alg_name_len = colon ? (colon - s) : strlen(s);
+    
+    if ( alg_name_len >= sizeof(alg_name) ) return false;
+    memcpy(alg_name, s, alg_name_len);
+    alg_name[alg_name_len] = '\0';
+    if ( (spec->algorithm = string_to_algorithm(alg_name)) == algorithm_invalid ) return false;
+    if ( colon ) {
+        char                *eos;
+        int                 d;
+        
+        s = colon + 1;
+        for ( d = 0; d < 3; d++ ) {
+            spec->n[d] = strtoul(s, &eos, 0);
+            if ( (spec->n[d] == 0) || (eos == s) ) return false;
+            if ( d < 2 ) {
+                if ( *eos != ',' ) return false;
+                s = eos + 1;
+            } else if ( *eos ) {
+                return false;
+            }
+        }
+    } else {
+        spec->n[0] = spec->n[1] = spec->n[2] = 0;
+    }
+    return true;
+}
+
+void
+tenant_result_send(void)
+{
+    if ( tenant_result_fd >= 0 ) {
+        ssize_t             n_bytes = write(tenant_result_fd, &tenant_result, sizeof(tenant_result));
+        
+        close(tenant_result_fd);
+        tenant_result_fd = -1;
+        if ( n_bytes != sizeof(tenant_result) ) exit(EIO);
+    }
+}
+
+/*
+ * Fill in the transpose kernel if the one selected is generated at run
+ * time and T's algorithm is one of the matrix algorithms, for the n1 in T.  Tenants call this after taking their own shape,
+ * and before they are released so that the compile is not timed; main calls
+ * it for a single transform.
+ */
+static transpose_kernel_t transform_jit_kernel;
+
+void
+transform_specialize_transpose(
+    transform_t     *T
+)
+{
+    switch ( T->algorithm ) {
+        case algorithm_matrix:
+        case algorithm_matrix_parallel:
+        case algorithm_matrix_uring:
+        case algorithm_matrix_async:
+            break;
+        default:
+            //
+            // Only the matrix algorithms transpose slabs:
+            //
+            return;
+    }
+    if ( ! T->transpose->fn ) {
+        //
+        // The kernel is specialized for n1; nk is a run-time argument, so
+        // the same one serves whole slabs and every k tile:
+        //
+        double              compile_seconds;
+        
+        transform_jit_kernel = *T->transpose;
+        if ( (transform_jit_kernel.fn = transpose_jit_compile(T->n[0], NULL, &compile_seconds)) ) {
+            if ( compile_seconds > 0.0 ) {
+                printf("INFO:  jit transpose kernel for n1 = %lu compiled in %.3lf s\n", T->n[0], compile_seconds);
+            } else {
+                printf("INFO:  jit transpose kernel for n1 = %lu loaded from the cache\n", T->n[0]);
+            }
+            T->transpose = &transform_jit_kernel;
+        } else {
+            printf("WARNING:  jit transpose kernel unavailable, using small_n1\n");
+            T->transpose = transpose_kernel_lookup("small_n1");
+        }
+    }
+    if ( (T->transpose->fn == transpose_small_n1) && ! transpose_small_n1_is_specialized(T->n[0]) ) {
+        printf("INFO:  no small_n1 kernel specialized for n1 = %lu, the tiled kernel is used\n", T->n[0]);
+    }
+}
+
+//
+
+/*
+ * Fork n_tenants copies of this transform.  Tenant t uses spec t modulo
+ * n_specs (an unspecified shape inherits the command line's), writes
+ * <output_file>.t, and when initializing creates its own <input_file>.t;
+ * otherwise all tenants read the same input file.  The memory budget is
+ * split evenly between tenants.  The children are released simultaneously,
+ * once each has specialized its transpose kernel, and this function returns
+ * only in the children; the parent waits for them all, reports per-tenant
+ * and aggregate throughput and exits.
+ */
+void
+tenants_run(
+    int                     n_tenants,
+    tenant_spec_t           *specs,
+    int                     n_specs,
+    transform_t             *T,
+    const char              **input_file,
+    const char              **output_file,
+    bool                    should_init_input
+)
+{
+    int                     result_pipe[2], go_pipe[2], ready_pipe[2], t, n_ok = 0, rc = 0;
+    tenant_result_t         results[n_tenants];
+    double                  sum_x = 0.0, sum_x2 = 0.0, min_x = HUGE_VAL, max_x = 0.0, span;
+    size_t                  total_bytes = 0;
+    struct timespec         first_start = { 0, 0 }, last_end = { 0, 0 };
+    
+    if ( (pipe(result_pipe) != 0) || (pipe(go_pipe) != 0) || (pipe(ready_pipe) != 0) ) {
+        fprintf(stderr, "ERROR:  unable to create tenant pipes (errno = %d)\n", errno);
+        exit(errno);
+    }
+    T->mem_budget /= n_tenants;
+    printf("INFO:  forking %d concurrent tenants, memory budget %s each\n", n_tenants, memory_with_natural_unit(T->mem_budget));
+    fflush(stdout);
+    
+    for ( t = 0; t < n_tenants; t++ ) {
+        pid_t               pid = fork();
+        
+        if ( pid < 0 ) {
+            fprintf(stderr, "ERROR:  unable to fork tenant %d (errno = %d)\n", t, errno);
+            exit(errno);
+        }
+        if ( pid == 0 ) {
+            tenant_spec_t   *spec = n_specs ? &specs[t % n_specs] : NULL;
+            char            go, *path;
+            
+            close(result_pipe[0]);
+            close(go_pipe[1]);
+            close(ready_pipe[0]);
+            setvbuf(stdout, NULL, _IOLBF, 0);
+            if ( spec ) {
+                T->algorithm = spec->algorithm;
+                if ( spec->n[0] ) T->n[0] = spec->n[0], T->n[1] = spec->n[1], T->n[2] = spec->n[2];
+            }
+            if ( *output_file ) {
+                path = malloc(strlen(*output_file) + 16);
+                sprintf(path, "%s.%d", *output_file, t);
+                *output_file = path;
+            }
+            if ( *input_file && should_init_input ) {
+                path = malloc(strlen(*input_file) + 16);
+                sprintf(path, "%s.%d", *input_file, t);
+                *input_file = path;
+            }
+            memset(&tenant_result, 0, sizeof(tenant_result));
+            tenant_result.tenant_idx = t;
+            tenant_result.pid = getpid();
+            tenant_result_fd = result_pipe[1];
+            
+            //
+            // Specialize the transpose kernel for this tenant, tell the
+            // parent it is ready and wait for it to release all tenants at
+            // once:
+            //
+            transform_specialize_transpose(T);
+            fflush(stdout);
+            go = 1;
+            if ( write(ready_pipe[1], &go, 1) != 1 ) exit(EIO);
+            close(ready_pipe[1]);
+            while ( (read(go_pipe[0], &go, 1) < 0) && (errno == EINTR) );
+            close(go_pipe[0]);
+            printf("INFO:  tenant %d (pid %d) using algorithm '%s' on (%lu, %lu, %lu)\n",
+                    t, (int)tenant_result.pid, algorithm_names[T->algorithm], T->n[0], T->n[1], T->n[2]);
+            return;
+        }
+    }
+    close(result_pipe[1]);
+    close(go_pipe[0]);
+    close(ready_pipe[1]);
+    for ( t = 0; t < n_tenants; t++ ) {
+        char                ready;
+        ssize_t             n_bytes = read(ready_pipe[0], &ready, 1);
+        
+        if ( (n_bytes < 0) && (errno == EINTR) ) {
+            t--;
+        } else if ( n_bytes != 1 ) {
+            break;
+        }
+    }
+    close(ready_pipe[0]);
+    close(go_pipe[1]);
+    
+    for ( t = 0; t < n_tenants; t++ ) {
+        ssize_t             n_bytes = read(result_pipe[0], &results[n_ok], sizeof(tenant_result_t));
+        
+        if ( n_bytes == sizeof(tenant_result_t) ) {
+            n_ok++;
+        } else if ( (n_bytes < 0) && (errno == EINTR) ) {
+            t--;
+        } else {
+            break;
+        }
+    }
+    close(result_pipe[0]);
+    for ( t = 0; t < n_tenants; t++ ) {
+        int                 status;
+        
+        if ( (wait(&status) > 0) && (! WIFEXITED(status) || WEXITSTATUS(status)) ) rc = ECHILD;
+    }
+    if ( n_ok < n_tenants ) {
+        fprintf(stderr, "ERROR:  only %d of %d tenants reported results\n", n_ok, n_tenants);
+        rc = ECHILD;
+    }
     
-    while ( (value > 1024.0) && (prefix_idx < prefix_max) ) value /= 1024.0, prefix_idx++;
-    if ( prefix_idx > 0 ) {
-        prefix_max = snprintf(memstr, sizeof(memstr), "%.2lf %sB (%llu bytes)", value, prefix[prefix_idx], (unsigned long long)bytes);
-    } else {
-        prefix_max = snprintf(memstr, sizeof(memstr), "%llu B", (unsigned long long)bytes);
+    for ( t = 0; t < n_ok; t++ ) {
+        tenant_result_t     *R = &results[t];
+        double              dt = (R->end.tv_sec - R->start.tv_sec) + 1e-9 * (R->end.tv_nsec - R->start.tv_nsec);
+        double              x = (dt > 0.0) ? (R->bytes / dt) : 0.0;
+        
+        printf("INFO:  tenant %d (pid %d):  %s in %.6lf s = %.2lf MiB/s\n",
+                R->tenant_idx, (int)R->pid, memory_with_natural_unit(R->bytes), dt, x / (1024.0 * 1024.0));
+        sum_x += x;
+        sum_x2 += x * x;
+        if ( x < min_x ) min_x = x;
+        if ( x > max_x ) max_x = x;
+        total_bytes += R->bytes;
+        if ( (t == 0) || (R->start.tv_sec < first_start.tv_sec) || ((R->start.tv_sec == first_start.tv_sec) && (R->start.tv_nsec < first_start.tv_nsec)) ) first_start = R->start;
+        if ( (t == 0) || (R->end.tv_sec > last_end.tv_sec) || ((R->end.tv_sec == last_end.tv_sec) && (R->end.tv_nsec > last_end.tv_nsec)) ) last_end = R->end;
     }
-    if ( prefix_max >= sizeof(memstr) ) {
-        fprintf(stderr, "CRITICAL:  memstr buffer too small in memory_with_natural_unit\n");
-        exit(ENOMEM);
+    if ( n_ok > 0 ) {
+        span = (last_end.tv_sec - first_start.tv_sec) + 1e-9 * (last_end.tv_nsec - first_start.tv_nsec);
+        printf("INFO:  aggregate %s in %.6lf s = %.2lf MiB/s (sum of tenant rates %.2lf MiB/s)\n",
+                memory_with_natural_unit(total_bytes), span, (span > 0.0) ? (total_bytes / span / (1024.0 * 1024.0)) : 0.0, sum_x / (1024.0 * 1024.0));
+        printf("INFO:  fairness:  Jain index %.4lf, slowest/fastest %.4lf\n",
+                (sum_x2 > 0.0) ? ((sum_x * sum_x) / (n_ok * sum_x2)) : 1.0, (max_x > 0.0) ? (min_x / max_x) : 1.0);
     }
-    return memstr;
+    exit(rc);
 }
 
 //
@@ -431,17 +6206,45 @@ main(
 {
     int                     opt_char, rc = 0;
     const char              *input_file = NULL, *output_file = NULL;
-    file_handle_t           in_fh, out_fh;
-    io_driver_t             use_io_driver = io_driver_fd;
-    file_handle_callbacks   *io_driver;
+    const char              *throughput_log_file = NULL;
+    transform_t             transform;
+    io_driver_t             use_in_driver = io_driver_fd, use_out_driver = io_driver_fd;
+    file_handle_callbacks   *in_driver, *out_driver;
+    char                    driver_desc[64];
     bool                    should_use_exact_dims = false;
     algorithm_t             use_algorithm = algorithm_jki_map;
     bool                    should_init_input = false;
-    unsigned long           i, j, k, n[3] = { 0, 0, 0 };
+    bool                    should_report_resources = false;
+    resource_snapshot_t     resources[2];
+    memory_budget_t         mem_budget = { 0, NULL };
+    size_t                  lossy_budget = (size_t)-1;
+    size_t                  reorder_window_bytes = 0;
+    int                     n_tenants = 1, n_tenant_specs = 0;
+    tenant_spec_t           tenant_specs[TENANT_MAX_SPECS];
+    char                    *driver_opts[DRIVER_OPT_MAX_COUNT];
+    int                     n_driver_opts = 0;
+    char                    driver_opts_desc[512] = "";
+    unsigned long           i, n[3] = { 0, 0, 0 };
     size_t                  l;
     struct stat             finfo;
     struct timespec         timer[2];
-    double                  dt;
+    double                  dt, *samples;
+    int                     rep, n_repeats = 1;
+    baseline_config_t       baseline = { ".", NULL, NULL, BASELINE_DEFAULT_THRESHOLD, BASELINE_DEFAULT_SIGNIFICANCE };
+    bool                    should_scale = false, should_scale_per_node = false;
+    bool                    is_fast_path_set = false;
+    scaling_run_t           runs[SCALING_MAX_RUNS];
+    int                     run, n_runs = 1;
+    size_t                  stream_bytes = 0;
+    transpose_stream_t      stream = { 0, 0.0, 0.0 };
+    
+    memset(&transform, 0, sizeof(transform));
+    transform.should_read = transform.should_write = true;
+    transform.n_threads = 1;
+    transform.uring_depth = URING_DEFAULT_DEPTH;
+    transform.async_depth = ASYNC_DEFAULT_DEPTH;
+    transform.transpose = &transpose_kernels[0];
+    transform.progress.interval = PROGRESS_DEFAULT_INTERVAL;
     
     //
     // Process CLI options:
@@ -468,6 +6271,8 @@ main(
                 break;
         
             case 'd':
+            case cli_option_input_driver:
+            case cli_option_output_driver:
                 if ( optarg && *optarg ) {
                     io_driver_t     d = string_to_io_driver(optarg);
                     
@@ -475,7 +6280,8 @@ main(
                         fprintf(stderr, "ERROR:  invalid i/o driver name: %s\n", optarg);
                         exit(EINVAL);
                     }
-                    use_io_driver = d;
+                    if ( opt_char != cli_option_output_driver ) use_in_driver = d;
+                    if ( opt_char != cli_option_input_driver ) use_out_driver = d;
                 } else {
                     fprintf(stderr, "ERROR:  invalid i/o driver name\n");
                     exit(EINVAL);
@@ -486,9 +6292,264 @@ main(
                 should_init_input = true;
                 break;
         
+            case 'm':
+                if ( optarg && *optarg ) {
+                    if ( strcasecmp(optarg, "auto") == 0 ) {
+                        mem_budget.budget = 0;
+                    } else if ( string_to_memory_size(optarg, &mem_budget.budget) && mem_budget.budget ) {
+                        mem_budget.source = "--memory-budget";
+                    } else {
+                        fprintf(stderr, "ERROR:  invalid memory budget: %s\n", optarg);
+                        exit(EINVAL);
+                    }
+                } else {
+                    fprintf(stderr, "ERROR:  invalid memory budget\n");
+                    exit(EINVAL);
+                }
+                break;
+        
             case 'x':
                 should_use_exact_dims = true;
                 break;
+            
+            case 'R':
+                transform.should_write = false;
+                break;
+            
+            case 'W':
+                transform.should_read = false;
+                break;
+            
+            case 'A':
+                should_report_resources = true;
+                break;
+            
+            case cli_option_progress: {
+                char            *eos = NULL;
+                double          v = optarg ? strtod(optarg, &eos) : -1.0;
+                
+                if ( (v >= 0.0) && (eos > optarg) && (*eos == '\0') ) {
+                    transform.progress.interval = v;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid progress interval: %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            }
+            
+            case cli_option_throughput_log:
+                if ( optarg && *optarg ) {
+                    throughput_log_file = (const char*)optarg;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid throughput log file name\n");
+                    exit(EINVAL);
+                }
+                break;
+            
+            case cli_option_repeat: {
+                char            *eos = NULL;
+                long            v = optarg ? strtol(optarg, &eos, 0) : 0;
+                
+                if ( (v > 0) && (v <= BASELINE_MAX_SAMPLES) && (eos > optarg) && (*eos == '\0') ) {
+                    n_repeats = v;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid repetition count (1 through %d): %s\n", BASELINE_MAX_SAMPLES, optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            }
+            
+            case cli_option_baseline_dir:
+            case cli_option_save_baseline:
+            case cli_option_compare_baseline:
+                if ( ! optarg || ! *optarg || ((opt_char != cli_option_baseline_dir) && strchr(optarg, '/')) ) {
+                    fprintf(stderr, "ERROR:  invalid baseline directory or name: %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                if ( opt_char == cli_option_baseline_dir ) baseline.dir = optarg;
+                else if ( opt_char == cli_option_save_baseline ) baseline.save_name = optarg;
+                else baseline.compare_name = optarg;
+                break;
+            
+            case cli_option_regression_threshold:
+            case cli_option_significance: {
+                char            *eos = NULL;
+                double          v = optarg ? strtod(optarg, &eos) : -1.0;
+                
+                if ( (v < 0.0) || (eos == optarg) || *eos || ((opt_char == cli_option_significance) && (v > 1.0)) ) {
+                    fprintf(stderr, "ERROR:  invalid %s: %s\n", (opt_char == cli_option_significance) ? "significance level" : "regression threshold", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                if ( opt_char == cli_option_significance ) baseline.significance = v;
+                else baseline.threshold = v;
+                break;
+            }
+            
+            case cli_option_threads: {
+                char            *eos = NULL;
+                long            v = optarg ? strtol(optarg, &eos, 0) : 0;
+                
+                if ( (v > 0) && (v <= SCALING_MAX_RUNS) && (eos > optarg) && (*eos == '\0') ) {
+                    transform.n_threads = v;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid thread count (1 through %d): %s\n", SCALING_MAX_RUNS, optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            }
+            
+            case cli_option_transpose_kernel:
+                if ( ! optarg || ! (transform.transpose = transpose_kernel_lookup(optarg)) ) {
+                    fprintf(stderr, "ERROR:  unknown transpose kernel: %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            
+            case cli_option_prefetch_distance: {
+                char            *eos = NULL;
+                long            v = optarg ? strtol(optarg, &eos, 0) : -1;
+                
+                if ( (v >= 0) && (v <= 1024) && (eos > optarg) && (*eos == '\0') ) {
+                    transpose_prefetch_distance = v;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid prefetch distance (0 through 1024 tiles): %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            }
+            
+            case cli_option_uring_depth: {
+                char            *eos = NULL;
+                long            v = optarg ? strtol(optarg, &eos, 0) : 0;
+                
+                if ( (v > 0) && (v <= 256) && (eos > optarg) && (*eos == '\0') ) {
+                    transform.uring_depth = v;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid io_uring depth (1 through 256): %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            }
+            
+            case cli_option_io_hints:
+                transform.io_hints = true;
+                break;
+            
+            case cli_option_preallocate:
+                transform.preallocate = true;
+                break;
+            
+            case cli_option_async_depth: {
+                char            *eos = NULL;
+                long            v = optarg ? strtol(optarg, &eos, 0) : 0;
+                
+                if ( (v > 0) && (v <= 256) && (eos > optarg) && (*eos == '\0') ) {
+                    transform.async_depth = v;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid asynchronous depth (1 through 256): %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            }
+            
+            case cli_option_uring_sqpoll:
+                transform.uring_sqpoll = true;
+                break;
+            
+            case cli_option_no_fast_path:
+            case cli_option_fast_path:
+                transform.no_fast_path = (opt_char == cli_option_no_fast_path) ? true : false;
+                is_fast_path_set = true;
+                break;
+            
+            case cli_option_calibrate:
+                stream_bytes = TRANSPOSE_STREAM_DEFAULT_BYTES;
+                if ( optarg && (! *optarg || ! string_to_memory_size(optarg, &stream_bytes) || (stream_bytes < sizeof(double))) ) {
+                    fprintf(stderr, "ERROR:  invalid STREAM array size: %s\n", optarg);
+                    exit(EINVAL);
+                }
+                break;
+            
+            case cli_option_scaling:
+                if ( optarg && strcasecmp(optarg, "numa") ) {
+                    fprintf(stderr, "ERROR:  invalid scaling mode: %s\n", optarg);
+                    exit(EINVAL);
+                }
+                should_scale = true;
+                should_scale_per_node = optarg ? true : false;
+                break;
+            
+            case cli_option_tenants: {
+                char            *eos = NULL;
+                long            v = optarg ? strtol(optarg, &eos, 0) : 0;
+                
+                if ( (v > 0) && (eos > optarg) && (*eos == '\0') ) {
+                    n_tenants = v;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid tenant count: %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            }
+            
+            case 'D':
+                //
+                // Applied once the driver has been chosen:
+                //
+                if ( n_driver_opts == DRIVER_OPT_MAX_COUNT ) {
+                    fprintf(stderr, "ERROR:  at most %d driver options may be specified\n", DRIVER_OPT_MAX_COUNT);
+                    exit(EINVAL);
+                }
+                if ( ! optarg || ! *optarg || (*optarg == '=') ) {
+                    fprintf(stderr, "ERROR:  invalid driver option: %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                driver_opts[n_driver_opts++] = optarg;
+                break;
+            
+            case cli_option_tenant:
+                if ( n_tenant_specs == TENANT_MAX_SPECS ) {
+                    fprintf(stderr, "ERROR:  at most %d tenants may be specified\n", TENANT_MAX_SPECS);
+                    exit(EINVAL);
+                }
+                if ( ! optarg || ! string_to_tenant_spec(optarg, &tenant_specs[n_tenant_specs]) ) {
+                    fprintf(stderr, "ERROR:  invalid tenant specification: %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                n_tenant_specs++;
+                break;
+            
+            case 'w':
+                if ( ! optarg || ! *optarg || ! string_to_memory_size(optarg, &reorder_window_bytes) ) {
+                    fprintf(stderr, "ERROR:  invalid reorder window size: %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            
+            case cli_option_transfer_chunk: {
+                size_t          chunk_size;
+                
+                if ( optarg && *optarg && string_to_memory_size(optarg, &chunk_size) && (chunk_size > 0) && (chunk_size <= IO_MAX_SINGLE_TRANSFER) ) {
+                    io_transfer_config.chunk_size = chunk_size;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid transfer chunk size (1 through %lu bytes): %s\n", (unsigned long)IO_MAX_SINGLE_TRANSFER, optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            }
+            
+            case cli_option_transfer_threads: {
+                char            *eos = NULL;
+                long            v = optarg ? strtol(optarg, &eos, 0) : 0;
+                
+                if ( (v > 0) && (eos > optarg) && (*eos == '\0') ) {
+                    io_transfer_config.n_threads = v;
+                } else {
+                    fprintf(stderr, "ERROR:  invalid transfer thread count: %s\n", optarg ? optarg : "");
+                    exit(EINVAL);
+                }
+                break;
+            }
                 
             case 'i':
                 if ( optarg && *optarg ) {
@@ -532,10 +6593,40 @@ main(
     }
     
     //
-    // Chooose the i/o driver:
+    // Chooose the i/o drivers; a driver option must be accepted by at least
+    // one of them:
     //
-    io_driver = io_driver_callbacks[use_io_driver];
-    printf("INFO:  using i/o driver '%s'\n", io_driver_names[use_io_driver]);
+    in_driver = io_driver_callbacks[use_in_driver];
+    out_driver = io_driver_callbacks[use_out_driver];
+    if ( use_in_driver == use_out_driver ) {
+        snprintf(driver_desc, sizeof(driver_desc), "%s", io_driver_names[use_in_driver]);
+        printf("INFO:  using i/o driver '%s'\n", io_driver_names[use_in_driver]);
+    } else {
+        snprintf(driver_desc, sizeof(driver_desc), "%s,%s", io_driver_names[use_in_driver], io_driver_names[use_out_driver]);
+        printf("INFO:  using i/o driver '%s' for input, '%s' for output\n", io_driver_names[use_in_driver], io_driver_names[use_out_driver]);
+    }
+    for ( i = 0; i < n_driver_opts; i++ ) {
+        char                *key = driver_opts[i], *value = strchr(key, '=');
+        bool                is_accepted;
+        
+        if ( value ) *value++ = '\0';
+        is_accepted = (in_driver->option && in_driver->option(key, value)) ? true : false;
+        if ( (out_driver != in_driver) && out_driver->option && out_driver->option(key, value) ) is_accepted = true;
+        if ( ! is_accepted ) {
+            fprintf(stderr, "ERROR:  invalid option for i/o driver '%s': %s%s%s\n", driver_desc, key, value ? "=" : "", value ? value : "");
+            exit(EINVAL);
+        }
+        printf("INFO:  i/o driver option %s%s%s\n", key, value ? "=" : "", value ? value : "");
+        snprintf(driver_opts_desc + strlen(driver_opts_desc), sizeof(driver_opts_desc) - strlen(driver_opts_desc), "%s%s%s%s",
+                i ? "," : " driver_opts=", key, value ? "=" : "", value ? value : "");
+    }
+    
+    transform.in_driver = in_driver;
+    transform.out_driver = out_driver;
+    if ( ! transform.should_read && ! transform.should_write ) {
+        fprintf(stderr, "ERROR:  --read-only and --write-only are mutually exclusive\n");
+        exit(EINVAL);
+    }
     
     //
     // Validate all dimensions provided:
@@ -547,522 +6638,397 @@ main(
         }
     }
     
+    //
+    // Determine how much memory the algorithms may allocate:
+    //
+    if ( mem_budget.budget == 0 ) memory_budget_detect(&mem_budget);
+    if ( mem_budget.budget == (size_t)-1 ) {
+        printf("INFO:  memory budget unlimited\n");
+    } else {
+        printf("INFO:  memory budget %s from %s\n", memory_with_natural_unit(mem_budget.budget), mem_budget.source);
+    }
+    
+    //
+    // Memory bandwidth reference for the transpose kernels:
+    //
+    if ( stream_bytes ) {
+        if ( stream_bytes > mem_budget.budget / 3 ) {
+            stream_bytes = mem_budget.budget / 3;
+            printf("WARNING:  STREAM arrays reduced to %s to fit the memory budget\n", memory_with_natural_unit(stream_bytes));
+        }
+        if ( ! transpose_stream_measure(stream_bytes / sizeof(double), TRANSPOSE_STREAM_PASSES, &stream) ) {
+            fprintf(stderr, "ERROR:  unable to allocate STREAM arrays of 3 x %s\n", memory_with_natural_unit(stream_bytes));
+            exit(ENOMEM);
+        }
+        printf("INFO:  STREAM copy %.3lf GB/s, triad %.3lf GB/s (3 x %s)\n", stream.copy, stream.triad, memory_with_natural_unit(sizeof(double) * stream.n_words));
+    }
+    
+    transform.mem_budget = mem_budget.budget;
+    transform.algorithm = use_algorithm;
+    transform.n[0] = n[0], transform.n[1] = n[1], transform.n[2] = n[2];
+    if ( n_tenant_specs > n_tenants ) n_tenants = n_tenant_specs;
+    
+    //
+    // A lossy file being written holds its incomplete slabs in memory, so
+    // half of the budget is set aside for them and the algorithm sizes its
+    // buffers from the other half:
+    //
+    if ( (((use_out_driver == io_driver_lossy) && transform.should_write) || ((use_in_driver == io_driver_lossy) && should_init_input)) && (transform.mem_budget != (size_t)-1) ) {
+        lossy_budget = transform.mem_budget / 2;
+        transform.mem_budget -= lossy_budget;
+        printf("INFO:  memory budget split %s for the algorithm,", memory_with_natural_unit(transform.mem_budget));
+        printf(" %s for the lossy driver\n", memory_with_natural_unit(lossy_budget));
+    }
+    
+    //
+    // Concurrent tenants?  Only the forked children return from this, each
+    // with its transpose kernel specialized:
+    //
+    if ( n_tenants > 1 ) {
+        tenants_run(n_tenants, tenant_specs, n_tenant_specs, &transform, &input_file, &output_file, should_init_input);
+    } else {
+        transform_specialize_transpose(&transform);
+    }
+    
+    //
+    // Progress reporting:
+    //
+    signal(SIGUSR1, progress_sigusr1_handler);
+    if ( throughput_log_file ) {
+        char                *path = (char*)throughput_log_file;
+        
+        if ( tenant_result_fd >= 0 ) {
+            path = malloc(strlen(throughput_log_file) + 16);
+            sprintf(path, "%s.%d", throughput_log_file, tenant_result.tenant_idx);
+        }
+        if ( ! (transform.progress.series = fopen(path, "a")) ) {
+            fprintf(stderr, "ERROR:  unable to open throughput log file %s (errno = %d)\n", path, errno);
+            exit(errno);
+        }
+    }
+    
     //
     // Validate input file name provided:
     //
-    if ( ! input_file ) {
+    if ( ! input_file && (should_init_input || transform.should_read) ) {
         fprintf(stderr, "ERROR:  no input file name provided\n");
         exit(EINVAL);
     }
     
+    //
+    // The lossy driver stores whole j slabs, so it needs the dimensions:
+    //
+    if ( (use_in_driver == io_driver_lossy) || (use_out_driver == io_driver_lossy) ) {
+        lossy_driver_set_dims(transform.n);
+        lossy_driver_set_budget((lossy_budget == (size_t)-1) ? lossy_budget : (lossy_budget / n_tenants));
+    }
+    
     //
     // Initialize the input file?
     //
     if ( should_init_input ) {
-        if ( ! io_driver->open(&in_fh, input_file, false, true, true) ) {
-            if ( errno != EEXIST ) {
-                fprintf(stderr, "ERROR:  unable to create input file (errno = %d)\n", errno);
-                exit(errno);
-            }
-            if ( ! io_driver->open(&in_fh, input_file, false, false, true) ) {
-                fprintf(stderr, "ERROR:  unable to truncate input file (errno = %d)\n", errno);
-                exit(errno);
-            }
-        }    
-        printf("INFO:  init input file using algorithm '%s'\n", algorithm_names[use_algorithm]);
-    
-        clock_gettime(CLOCK_MONOTONIC, &timer[0]);
-    
-        switch ( use_algorithm ) {
-    
-            case algorithm_invalid:
-            case algorithm_max:
-                break;
-            
-            case algorithm_ijk_map: {
-                for ( i=0; i<n[0]; i++ ) {
-                    for ( j=0; j<n[1]; j++ ) {
-                        for ( k=0; k<n[2]; k++ ) {
-                            ssize_t n_bytes;
-                            
-                            double v = offset_ijk(n, i, j, k);
-                            n_bytes = io_driver->write(&in_fh, &v, sizeof(v));
-                            if ( n_bytes <= 0 ) {
-                                fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to input file (errno = %d)\n", i, j, k, errno);
-                                exit(errno);
-                            }
-                        }
-                    }
-                }
-                break;
-            }
-            
-            case algorithm_jki_map: {
-                for ( j=0; j<n[1]; j++ ) {
-                    for ( k=0; k<n[2]; k++ ) {
-                        for ( i=0; i<n[0]; i++ ) {
-                            ssize_t n_bytes;
-                            
-                            double v = offset_jki(n, i, j, k);
-                            n_bytes = io_driver->write(&in_fh, &v, sizeof(v));
-                            if ( n_bytes <= 0 ) {
-                                fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to input file (errno = %d)\n", i, j, k, errno);
-                                exit(errno);
-                            }
-                        }
-                    }
-                }
-                break;
-            }
-            
-            case algorithm_jik_map: {
-                for ( i=0; i<n[0]; i++ ) {
-                    for ( j=0; j<n[1]; j++ ) {
-                        for ( k=0; k<n[2]; k++ ) {
-                            ssize_t n_bytes;
-                            
-                            double v = offset_jik(n, i, j, k);
-                            n_bytes = io_driver->write(&in_fh, &v, sizeof(v));
-                            if ( n_bytes <= 0 ) {
-                                fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to input file (errno = %d)\n", i, j, k, errno);
-                                exit(errno);
-                            }
-                        }
-                    }
-                }
-                break;
-            }
-            
-            case algorithm_vector_input: {
-                size_t      v_len = sizeof(double) * n[0];
-                double      *v = (double*)malloc(v_len);
-                    
-                if ( ! v ) {
-                    fprintf(stderr, "ERROR:  unable to allocate init read vector in vector_input\n");
-                    exit(ENOMEM);
-                }
-                printf("INFO:  init read vector of size %s allocated\n", memory_with_natural_unit(v_len));
-                
-                for ( j=0; j<n[1]; j++ ) {
-                    for ( k=0; k<n[2]; k++ ) {
-                        ssize_t n_bytes;
-                        
-                        for ( i=0; i<n[0]; i++ ) v[i] = offset_jki(n, i, j, k);
-                        n_bytes = io_driver->write(&in_fh, v, v_len);
-                    }
-                }
-                free((void*)v);
-                break;
-            }
-            
-            case algorithm_vector_output: {
-                size_t      v_len = sizeof(double) * n[2];
-                double      *v = (double*)malloc(v_len);
-                    
-                if ( ! v ) {
-                    fprintf(stderr, "ERROR:  unable to allocate init write vector in vector_input\n");
-                    exit(ENOMEM);
-                }
-                printf("INFO:  init write vector of size %s allocated\n", memory_with_natural_unit(v_len));
-                
-                for ( j=0; j<n[1]; j++ ) {
-                    for ( i=0; i<n[0]; i++ ) {
-                        ssize_t n_bytes;
-                        
-                        for ( k=0; k<n[2]; k++ ) v[k] = offset_jki(n, i, j, k);
-                        n_bytes = io_driver->write(&in_fh, v, v_len);
-                    }
-                }
-                free((void*)v);
-                break;
-            }
-            
-            case algorithm_matrix: {
-                size_t      v_len = sizeof(double) * n[0] * n[2];
-                double      *v = (double*)malloc(v_len);
-                    
-                if ( ! v ) {
-                    fprintf(stderr, "ERROR:  unable to allocate init read+write matrix in matrix\n");
-                    exit(ENOMEM);
-                }
-                printf("INFO:  init read+write matrix of size %s allocated\n", memory_with_natural_unit(v_len));
-            
-                for ( j=0; j<n[1]; j++ ) {
-                    ssize_t n_bytes;
-                    
-                    for ( k=0; k<n[2]; k++ ) {
-                        for ( i=0; i<n[0]; i++ ) {
-                            v[n[0] * k + i] = offset_jki(n, i, j, k);
-                        }
-                    }
-                    n_bytes = io_driver->write(&in_fh, v, v_len);
-                }
-                free((void*)v);
-                break;
+        if ( ! in_driver->open(&transform.in_fh, input_file, false, true, true) ) {
+            if ( errno != EEXIST ) {
+                fprintf(stderr, "ERROR:  unable to create input file (errno = %d)\n", errno);
+                exit(errno);
             }
-            
-        }
-        io_driver->close(&in_fh);
+            if ( ! in_driver->open(&transform.in_fh, input_file, false, false, true) ) {
+                fprintf(stderr, "ERROR:  unable to truncate input file (errno = %d)\n", errno);
+                exit(errno);
+            }
+        }    
+        printf("INFO:  init input file using algorithm '%s'\n", algorithm_names[transform.algorithm]);
+    
+        if ( should_report_resources ) resource_snapshot_take(&resources[0]);
+        clock_gettime(CLOCK_MONOTONIC, &timer[0]);
+        progress_start(&transform.progress, "init", sizeof(double) * transform.n[0] * transform.n[1] * transform.n[2], sizeof(double) * transform.n[0] * transform.n[2]);
+    
+        transform_init_input(&transform);
+        progress_finish(&transform.progress);
+        in_driver->close(&transform.in_fh);
         clock_gettime(CLOCK_MONOTONIC, &timer[1]);
         dt = (timer[1].tv_sec - timer[0].tv_sec) + 1e-9 * (timer[1].tv_nsec - timer[0].tv_nsec);
     
         printf("INFO:  elapsed file init time %.6lf s\n", dt); 
-        if ( ! output_file ) exit(0);   
+        if ( should_report_resources ) {
+            resource_snapshot_take(&resources[1]);
+            resource_report("init", &resources[0], &resources[1], 0,
+                    sizeof(double) * transform.n[0] * transform.n[1] * transform.n[2],
+                    transform.n[0] * transform.n[1] * transform.n[2]);
+        }
+        tenant_result.init_time = dt;
+        if ( ! output_file && transform.should_write ) {
+            tenant_result.bytes = sizeof(double) * transform.n[0] * transform.n[1] * transform.n[2];
+            tenant_result.start = timer[0];
+            tenant_result.end = timer[1];
+            tenant_result_send();
+            exit(0);
+        }
     }
     
     //
     // Validate output file name provided:
     //
-    if ( ! output_file ) {
+    if ( ! output_file && transform.should_write ) {
         fprintf(stderr, "ERROR:  no output file name provided\n");
         exit(EINVAL);
     }
     
-    //
-    // Get the input file opened:
-    //
-    if ( ! io_driver->open(&in_fh, input_file, true, false, false) ) {
-        fprintf(stderr, "ERROR:  unable to open input file for reading (errno = %d)\n", errno);
-        exit(errno);
-    }
-    printf("INFO:  input file open for reading: %s\n", input_file);
-    
-    //
-    // Check the size of the input file:
-    //
-    if ( ! io_driver->stat(&in_fh, &finfo) ) {
-        fprintf(stderr, "ERROR:  unable to get metadata for input file (errno = %d)\n", errno);
-        exit(errno);
-    }
     // Anticipated size of data:
-    l = sizeof(double) * n[0] * n[1] * n[2];
-    if ( finfo.st_size < l ) {
-        fprintf(stderr, "ERROR:  input file is too small for dimensions (%lu, %lu, %lu): %lld\n", n[0], n[1], n[2], finfo.st_size);
-        exit(EINVAL);
-    }
-    if ( (finfo.st_size > l) && should_use_exact_dims ) {
-        fprintf(stderr, "ERROR:  input file is too large for dimensions (%lu, %lu, %lu): %lld\n", n[0], n[1], n[2], finfo.st_size);
-        exit(EINVAL);
-    }
-    printf("INFO:  (%lu, %lu, %lu) data source is %s\n"
-           "INFO:  input file is %s\n",
-           n[0], n[1], n[2], memory_with_natural_unit((size_t)l), memory_with_natural_unit((size_t)finfo.st_size));
+    l = sizeof(double) * transform.n[0] * transform.n[1] * transform.n[2];
     
-    //
-    // Try to create the output file:
-    //
-    if ( ! io_driver->open(&out_fh, output_file, false, true, false) ) {
-        if ( errno != EEXIST ) {
-            fprintf(stderr, "ERROR:  unable to create output file (errno = %d)\n", errno);
-            exit(errno);
-        }
+    if ( transform.should_read ) {
         //
-        // The file already exists, so get it opened w/o asking to create it:
+        // Get the input file opened:
         //
-        if ( ! io_driver->open(&out_fh, output_file, false, false, false) ) {
-            fprintf(stderr, "ERROR:  unable to open output file (errno = %d)\n", errno);
+        if ( ! in_driver->open(&transform.in_fh, input_file, true, false, false) ) {
+            fprintf(stderr, "ERROR:  unable to open input file for reading (errno = %d)\n", errno);
             exit(errno);
         }
-        
+        printf("INFO:  input file open for reading: %s\n", input_file);
+    
         //
-        // Check the size of the output file:
+        // Check the size of the input file:
         //
-        if ( ! io_driver->stat(&out_fh, &finfo) ) {
-            fprintf(stderr, "ERROR:  unable to get metadata for output file (errno = %d)\n", errno);
+        if ( ! in_driver->stat(&transform.in_fh, &finfo) ) {
+            fprintf(stderr, "ERROR:  unable to get metadata for input file (errno = %d)\n", errno);
             exit(errno);
         }
         if ( finfo.st_size < l ) {
-            fprintf(stderr, "ERROR:  output file is too small for dimensions (%lu, %lu, %lu): %lld\n", n[0], n[1], n[2], finfo.st_size);
+            fprintf(stderr, "ERROR:  input file is too small for dimensions (%lu, %lu, %lu): %lld\n", transform.n[0], transform.n[1], transform.n[2], finfo.st_size);
             exit(EINVAL);
         }
         if ( (finfo.st_size > l) && should_use_exact_dims ) {
-            fprintf(stderr, "ERROR:  output file is too large for dimensions (%lu, %lu, %lu): %lld\n", n[0], n[1], n[2], finfo.st_size);
+            fprintf(stderr, "ERROR:  input file is too large for dimensions (%lu, %lu, %lu): %lld\n", transform.n[0], transform.n[1], transform.n[2], finfo.st_size);
             exit(EINVAL);
         }
         printf("INFO:  (%lu, %lu, %lu) data source is %s\n"
-               "INFO:  output file is %s\n",
-               n[0], n[1], n[2], memory_with_natural_unit((size_t)l), memory_with_natural_unit((size_t)finfo.st_size));
+               "INFO:  input file is %s\n",
+               transform.n[0], transform.n[1], transform.n[2], memory_with_natural_unit((size_t)l), memory_with_natural_unit((size_t)finfo.st_size));
+    } else {
+        printf("INFO:  write-only mode, input file reads replaced by synthetic data\n");
+    }
+    
+    if ( transform.should_write ) {
+#ifdef HAVE_HDF5
+        if ( use_out_driver == io_driver_hdf5 ) hdf5_driver_set_dims(transform.n);
+#endif
+        //
+        // Try to create the output file:
+        //
+        if ( ! out_driver->open(&transform.out_fh, output_file, false, true, false) ) {
+            if ( errno != EEXIST ) {
+                fprintf(stderr, "ERROR:  unable to create output file (errno = %d)\n", errno);
+                exit(errno);
+            }
+            //
+            // The file already exists, so get it opened w/o asking to create it:
+            //
+            if ( ! out_driver->open(&transform.out_fh, output_file, false, false, false) ) {
+                fprintf(stderr, "ERROR:  unable to open output file (errno = %d)\n", errno);
+                exit(errno);
+            }
+        
+            //
+            // Check the size of the output file:
+            //
+            if ( ! out_driver->stat(&transform.out_fh, &finfo) ) {
+                fprintf(stderr, "ERROR:  unable to get metadata for output file (errno = %d)\n", errno);
+                exit(errno);
+            }
+            if ( finfo.st_size < l ) {
+                fprintf(stderr, "ERROR:  output file is too small for dimensions (%lu, %lu, %lu): %lld\n", transform.n[0], transform.n[1], transform.n[2], finfo.st_size);
+                exit(EINVAL);
+            }
+            if ( (finfo.st_size > l) && should_use_exact_dims ) {
+                fprintf(stderr, "ERROR:  output file is too large for dimensions (%lu, %lu, %lu): %lld\n", transform.n[0], transform.n[1], transform.n[2], finfo.st_size);
+                exit(EINVAL);
+            }
+            printf("INFO:  (%lu, %lu, %lu) data source is %s\n"
+                   "INFO:  output file is %s\n",
+                   transform.n[0], transform.n[1], transform.n[2], memory_with_natural_unit((size_t)l), memory_with_natural_unit((size_t)finfo.st_size));
         
+        }
+        printf("INFO:  output file open for writing: %s\n", output_file);
+    } else {
+        printf("INFO:  read-only mode, output file writes skipped\n");
     }
-    printf("INFO:  output file open for writing: %s\n", output_file);
     
-    printf("INFO:  using algorithm '%s'\n", algorithm_names[use_algorithm]);
+    printf("INFO:  using algorithm '%s'\n", algorithm_names[transform.algorithm]);
     
-    clock_gettime(CLOCK_MONOTONIC, &timer[0]);
+    if ( ! (samples = (double*)malloc(n_repeats * sizeof(double))) ) {
+        fprintf(stderr, "ERROR:  unable to allocate timing samples\n");
+        exit(ENOMEM);
+    }
     
-    switch ( use_algorithm ) {
+    //
+    // A scaling study is a series of runs at increasing thread counts:
+    //
+    if ( should_scale ) {
+        if ( transform.algorithm != algorithm_matrix_parallel ) {
+            fprintf(stderr, "ERROR:  --scaling requires algorithm 'matrix_parallel'\n");
+            exit(EINVAL);
+        }
+        if ( baseline.save_name || baseline.compare_name ) {
+            fprintf(stderr, "ERROR:  --scaling cannot be combined with baselines\n");
+            exit(EINVAL);
+        }
+        n_runs = scaling_plan(runs, should_scale_per_node);
+        printf("INFO:  thread scaling study of %d run(s)\n", n_runs);
+    } else {
+        runs[0] = (scaling_run_t){ -1, transform.n_threads, 0.0 };
+    }
     
-        case algorithm_invalid:
-        case algorithm_max:
-            break;
-            
-        case algorithm_ijk_map: {
-            for ( i=0; i<n[0]; i++ ) {
-                for ( j=0; j<n[1]; j++ ) {
-                    for ( k=0; k<n[2]; k++ ) {
-                        ssize_t     n_bytes;
-                        double      v;
-                        off_t       fp = sizeof(double) * offset_jki(n, i, j, k);
-                        
-                        if ( io_driver->seek(&in_fh, fp) < 0 ) {
-                            fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) = %lld in input file (errno = %d)\n", i, j, k, fp, errno);
-                            exit(errno);
-                        }
-                        n_bytes = io_driver->read(&in_fh, &v, sizeof(v));
-                        if ( n_bytes <= 0 ) {
-                            if ( n_bytes == 0 ) {
-                                fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
-                                exit(EINVAL);
-                            }
-                            fprintf(stderr, "ERROR:  unable to read (%lu, %lu, %lu) from input file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                        fp = sizeof(double) * offset_jik(n, i, j, k);
-                        
-                        if ( io_driver->seek(&out_fh, fp) < 0 ) {
-                            fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) in output file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                        n_bytes = io_driver->write(&out_fh, &v, sizeof(v));
-                        if ( n_bytes <= 0 ) {
-                            fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to output file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                    }
-                }
-            }
-            break;
+    //
+    // Repetitions, scaling studies and baselines are there to time the
+    // algorithm, so for n1 == 1 or n3 == 1 they skip the fast path unless
+    // it was asked for:
+    //
+    if ( ! is_fast_path_set && ((n_repeats > 1) || should_scale || baseline.save_name || baseline.compare_name) ) {
+        transform.no_fast_path = true;
+        if ( (transform.n[0] == 1) || (transform.n[2] == 1) ) {
+            printf("INFO:  n%c = 1, timing algorithm '%s' rather than the in-kernel copy (--fast-path to time the copy)\n", (transform.n[0] == 1) ? '1' : '3', algorithm_names[transform.algorithm]);
         }
-            
-        case algorithm_jki_map: {
-            for ( j=0; j<n[1]; j++ ) {
-                for ( k=0; k<n[2]; k++ ) {
-                    for ( i=0; i<n[0]; i++ ) {
-                        ssize_t     n_bytes;
-                        double      v;
-                        off_t       fp = sizeof(double) * offset_jki(n, i, j, k);
-                        
-                        if ( io_driver->seek(&in_fh, fp) < 0 ) {
-                            fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) = %lld in input file (errno = %d)\n", i, j, k, fp, errno);
-                            exit(errno);
-                        }
-                        n_bytes = io_driver->read(&in_fh, &v, sizeof(v));
-                        if ( n_bytes <= 0 ) {
-                            if ( n_bytes == 0 ) {
-                                fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
-                                exit(EINVAL);
-                            }
-                            fprintf(stderr, "ERROR:  unable to read (%lu, %lu, %lu) from input file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                        fp = sizeof(double) * offset_jik(n, i, j, k);
-                        
-                        if ( io_driver->seek(&out_fh, fp) < 0 ) {
-                            fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) in output file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                        n_bytes = io_driver->write(&out_fh, &v, sizeof(v));
-                        if ( n_bytes <= 0 ) {
-                            fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to output file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                    }
+    }
+    
+    //
+    // Element-wise algorithms can have their i/o gathered in a reorder window:
+    //
+    if ( reorder_window_bytes ) {
+        switch ( transform.algorithm ) {
+            case algorithm_ijk_map:
+            case algorithm_jki_map:
+            case algorithm_jik_map:
+                if ( reorder_window_bytes > mem_budget.budget ) {
+                    fprintf(stderr, "ERROR:  reorder window exceeds the memory budget\n");
+                    exit(ENOMEM);
                 }
-            }
-            break;
-        }
-            
-        case algorithm_jik_map: {
-            for ( j=0; j<n[1]; j++ ) {
-                for ( i=0; i<n[0]; i++ ) {
-                    for ( k=0; k<n[2]; k++ ) {
-                        ssize_t     n_bytes;
-                        double      v;
-                        off_t       fp = sizeof(double) * offset_jki(n, i, j, k);
-                        
-                        if ( io_driver->seek(&in_fh, fp) < 0 ) {
-                            fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) = %lld in input file (errno = %d)\n", i, j, k, fp, errno);
-                            exit(errno);
-                        }
-                        n_bytes = io_driver->read(&in_fh, &v, sizeof(v));
-                        if ( n_bytes <= 0 ) {
-                            if ( n_bytes == 0 ) {
-                                fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
-                                exit(EINVAL);
-                            }
-                            fprintf(stderr, "ERROR:  unable to read (%lu, %lu, %lu) from input file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                        fp = sizeof(double) * offset_jik(n, i, j, k);
-                        
-                        if ( io_driver->seek(&out_fh, fp) < 0 ) {
-                            fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) in output file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                        n_bytes = io_driver->write(&out_fh, &v, sizeof(v));
-                        if ( n_bytes <= 0 ) {
-                            fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to output file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                    }
+                if ( ! reorder_window_init(&transform.reorder, reorder_window_bytes, in_driver, &transform.in_fh, out_driver, &transform.out_fh, transform.should_read, transform.should_write) ) {
+                    fprintf(stderr, "ERROR:  unable to allocate reorder window of size %s\n", memory_with_natural_unit(reorder_window_bytes));
+                    exit(ENOMEM);
                 }
-            }
-            break;
+                printf("INFO:  reorder window of %lu elements allocated\n", (unsigned long)transform.reorder.capacity);
+                break;
+            default:
+                printf("WARNING:  reorder window ignored by algorithm '%s'\n", algorithm_names[transform.algorithm]);
+                break;
         }
-        
-        case algorithm_vector_input: {
-            size_t      v_len = sizeof(double) * n[0];
-            double      *v = (double*)malloc(v_len);
-                    
-            if ( ! v ) {
-                fprintf(stderr, "ERROR:  unable to allocate read vector in vector_input\n");
-                exit(ENOMEM);
+    }
+    
+    for ( run = 0; run < n_runs; run++ ) {
+        if ( should_scale ) {
+            if ( (run == 0) || (runs[run].node != runs[run - 1].node) ) scaling_pin(runs[run].node);
+            transform.n_threads = runs[run].n_threads;
+        }
+        for ( rep = 0; rep < n_repeats; rep++ ) {
+            if ( ((run > 0) || (rep > 0)) && transform.should_write && ! out_driver->open(&transform.out_fh, output_file, false, false, false) ) {
+                fprintf(stderr, "ERROR:  unable to reopen output file (errno = %d)\n", errno);
+                exit(errno);
             }
-            printf("INFO:  read vector of size %s allocated\n", memory_with_natural_unit(v_len));
-            
-            for ( j=0; j<n[1]; j++ ) {
-                for ( k=0; k<n[2]; k++ ) {
-                    ssize_t     n_bytes;
-                    off_t       fp = sizeof(double) * offset_jki(n, 0, j, k);
-                    
-                    if ( io_driver->seek(&in_fh, fp) < 0 ) {
-                        fprintf(stderr, "ERROR:  unable to seek to (..., %lu, %lu) = %lld in input file (errno = %d)\n", j, k, fp, errno);
-                        exit(errno);
-                    }
-                    n_bytes = io_driver->read(&in_fh, v, v_len);
-                    if ( n_bytes <= 0 ) {
-                        if ( n_bytes == 0 ) {
-                            fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
-                            exit(EINVAL);
-                        }
-                        fprintf(stderr, "ERROR:  unable to read (..., %lu, %lu) from input file (errno = %d)\n", j, k, errno);
-                        exit(errno);
-                    }
-                    for ( i=0; i<n[0]; i++ ) {
-                        fp = sizeof(double) * offset_jik(n, i, j, k);
-                    
-                        if ( io_driver->seek(&out_fh, fp) < 0 ) {
-                            fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) in output file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                        n_bytes = io_driver->write(&out_fh, v + i, sizeof(double));
-                        if ( n_bytes <= 0 ) {
-                            fprintf(stderr, "ERROR:  unable to write (%lu, %lu, %lu) to output file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                    }
+            if ( should_report_resources ) resource_snapshot_take(&resources[0]);
+            transform.transpose_seconds = 0.0;
+            transform.transpose_bytes = 0;
+            clock_gettime(CLOCK_MONOTONIC, &timer[0]);
+            progress_start(&transform.progress, "processing", l, sizeof(double) * transform.n[0] * transform.n[2]);
+        
+            transform_process(&transform);
+            if ( transform.reorder.capacity ) reorder_window_flush(&transform.reorder);
+            progress_finish(&transform.progress);
+            if ( transform.should_write ) out_driver->close(&transform.out_fh);
+            clock_gettime(CLOCK_MONOTONIC, &timer[1]);
+            dt = (timer[1].tv_sec - timer[0].tv_sec) + 1e-9 * (timer[1].tv_nsec - timer[0].tv_nsec);
+            samples[rep] = dt;
+        
+            printf("INFO:  elapsed file processing time %.6lf s\n", dt);
+            if ( transform.transpose_bytes && (transform.transpose_seconds > 0.0) ) {
+                double      gbs = transform.transpose_bytes / transform.transpose_seconds / 1e9;
+                
+                printf("INFO:  transpose kernel '%s' moved %s in %.6lf s (%.1lf%% of processing time), %.3lf GB/s per thread",
+                        transform.transpose->name, memory_with_natural_unit(transform.transpose_bytes), transform.transpose_seconds,
+                        100.0 * transform.transpose_seconds / dt / transform.n_threads, gbs);
+                if ( stream.copy > 0.0 ) {
+                    printf(", %.1lf%% of STREAM copy, %.1lf%% of triad", 100.0 * gbs / stream.copy, 100.0 * gbs / stream.triad);
                 }
+                printf("\n");
             }
-            free((void*)v);
-            break;
+            if ( should_report_resources ) {
+                resource_snapshot_take(&resources[1]);
+                resource_report("processing", &resources[0], &resources[1],
+                        transform.should_read ? l : 0, transform.should_write ? l : 0,
+                        transform.n[0] * transform.n[1] * transform.n[2]);
+            }
+            if ( (run == 0) && (rep == 0) ) tenant_result.start = timer[0];
         }
+        runs[run].dt = samples[0];
+        for ( rep = 1; rep < n_repeats; rep++ ) if ( samples[rep] < runs[run].dt ) runs[run].dt = samples[rep];
+        if ( n_repeats > 1 ) {
+            double              mean, sd;
         
-        case algorithm_vector_output: {
-            size_t      v_len = sizeof(double) * n[2];
-            double      *v = (double*)malloc(v_len);
-                    
-            if ( ! v ) {
-                fprintf(stderr, "ERROR:  unable to allocate write vector in vector_output\n");
-                exit(ENOMEM);
-            }
-            printf("INFO:  write vector of size %s allocated\n", memory_with_natural_unit(v_len));
-            
-            for ( j=0; j<n[1]; j++ ) {
-                for ( i=0; i<n[0]; i++ ) {
-                    off_t           fp;
-                    ssize_t         n_bytes;
-                    
-                    for ( k=0; k<n[2]; k++ ) {
-                        fp = sizeof(double) * offset_jki(n, i, j, k);
-                        if ( io_driver->seek(&in_fh, fp) < 0 ) {
-                            fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, %lu) = %lld in input file (errno = %d)\n", i, j, k, fp, errno);
-                            exit(errno);
-                        }
-                        n_bytes = io_driver->read(&in_fh, v + k, sizeof(double));
-                        if ( n_bytes <= 0 ) {
-                            if ( n_bytes == 0 ) {
-                                fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
-                                exit(EINVAL);
-                            }
-                            fprintf(stderr, "ERROR:  unable to read (%lu, %lu, %lu) from input file (errno = %d)\n", i, j, k, errno);
-                            exit(errno);
-                        }
-                    }
-                    
-                    fp = sizeof(double) * offset_jik(n, i, j, 0);
-                    
-                    if ( io_driver->seek(&out_fh, fp) < 0 ) {
-                        fprintf(stderr, "ERROR:  unable to seek to (%lu, %lu, ...) in output file (errno = %d)\n", i, j, errno);
-                        exit(errno);
-                    }
-                    n_bytes = io_driver->write(&out_fh, v, v_len);
-                    if ( n_bytes <= 0 ) {
-                        fprintf(stderr, "ERROR:  unable to write (%lu, %lu, ...) to output file (errno = %d)\n", i, j, errno);
-                        exit(errno);
-                    }
-                }
-            }
-            free((void*)v);
-            break;
+            stats_mean_stddev(samples, n_repeats, &mean, &sd);
+            printf("INFO:  file processing time over %d repetitions:  mean %.6lf s, stddev %.6lf s, min %.6lf s\n", n_repeats, mean, sd, runs[run].dt);
         }
+    }
+    if ( should_scale ) {
+        scaling_pin(-1);
+        scaling_report(runs, n_runs, l);
+    }
+    if ( transform.should_write ) {
+        long                    n_extents = file_extent_count(output_file);
         
-        case algorithm_matrix: {
-            size_t      v_len = sizeof(double) * n[0] * n[2];
-            double      *v1 = (double*)malloc(2 * v_len);
-            double      *v2;
-                    
-            if ( ! v1 ) {
-                fprintf(stderr, "ERROR:  unable to allocate read+write matrices in matrix\n");
-                exit(ENOMEM);
-            }
-            printf("INFO:  read+write matrices of size 2 x %s allocated\n", memory_with_natural_unit(v_len));
-            v2 = v1 + n[0] * n[2];
-            
-            for ( j=0; j<n[1]; j++ ) {
-                ssize_t     n_bytes;
-                off_t       fp = sizeof(double) * offset_jki(n, 0, j, 0);
-                
-                if ( io_driver->seek(&in_fh, fp) < 0 ) {
-                    fprintf(stderr, "ERROR:  unable to seek to (..., %lu, ...) = %lld in input file (errno = %d)\n", j, fp, errno);
-                    exit(errno);
-                }
-                n_bytes = io_driver->read(&in_fh, v1, v_len);
-                if ( n_bytes <= 0 ) {
-                    if ( n_bytes == 0 ) {
-                        fprintf(stderr, "ERROR:  unexpected end-of-file on input file\n");
-                        exit(EINVAL);
-                    }
-                    fprintf(stderr, "ERROR:  unable to read (..., %lu, ...) from input file (errno = %d)\n", j, errno);
-                    exit(errno);
-                }
-                for ( i=0; i<n[0]; i++ ) {
-                    for ( k=0; k<n[2]; k++ ) {
-                        v2[i * n[2] + k] = v1[k * n[0] + i];
-                    }
-                }
-                fp = sizeof(double) * offset_jik(n, 0, j, 0);
+        if ( n_extents >= 0 ) printf("INFO:  output file occupies %ld extent(s)\n", n_extents);
+    }
+    if ( transform.reorder.capacity ) {
+        printf("INFO:  reorder window issued %lu reads and %lu writes for %lu elements\n", transform.reorder.n_reads, transform.reorder.n_writes, transform.reorder.n_elements);
+        reorder_window_destroy(&transform.reorder);
+    }
+    tenant_result.bytes = l * n_repeats * n_runs;
+    tenant_result.end = timer[1];
+    tenant_result_send();
+    
+    //
+    // Save and/or compare against a baseline:
+    //
+    if ( baseline.save_name || baseline.compare_name ) {
+        char                key[1024], key_opts[256] = "";
+        
+        //
+        // Driver options and settings away from their defaults are only part
+        // of the key when given, so keys saved before they existed still
+        // match:
+        //
+        if ( ! transform.no_fast_path && ((transform.n[0] == 1) || (transform.n[2] == 1)) ) strcat(key_opts, " fast_path");
+        if ( transform.uring_depth != URING_DEFAULT_DEPTH ) snprintf(key_opts + strlen(key_opts), sizeof(key_opts) - strlen(key_opts), " uring_depth=%d", transform.uring_depth);
+        if ( transform.uring_sqpoll ) strcat(key_opts, " uring_sqpoll");
+        if ( transform.async_depth != ASYNC_DEFAULT_DEPTH ) snprintf(key_opts + strlen(key_opts), sizeof(key_opts) - strlen(key_opts), " async_depth=%d", transform.async_depth);
+        if ( transform.preallocate ) strcat(key_opts, " preallocate");
+        if ( transform.io_hints ) strcat(key_opts, " io_hints");
+        //
+        // The memory budget (from MemAvailable or the cgroup by default)
+        // reaches the timing through the matrix algorithms' batch and tile
+        // sizes, so those are keyed:
+        //
+        if ( transform.plan.slabs_per_batch ) {
+            snprintf(key_opts + strlen(key_opts), sizeof(key_opts) - strlen(key_opts), " plan=%lux%lu", transform.plan.slabs_per_batch, transform.plan.k_per_tile);
+        }
+        snprintf(key, sizeof(key), "algorithm=%s driver=%s n=%lu,%lu,%lu threads=%d kernel=%s prefetch=%d mode=%s reorder=%llu chunk=%llu transfer_threads=%d%s%s",
+                algorithm_names[transform.algorithm], driver_desc,
+                transform.n[0], transform.n[1], transform.n[2], transform.n_threads, transform.transpose->name, transpose_prefetch_distance,
+                transform.should_read ? (transform.should_write ? "rw" : "r") : "w",
+                (unsigned long long)reorder_window_bytes, (unsigned long long)io_transfer_config.chunk_size,
+                io_transfer_config.n_threads, driver_opts_desc, key_opts);
+        if ( baseline.compare_name && baseline_compare(&baseline, key, samples, n_repeats) ) rc = BASELINE_REGRESSION_EXIT_STATUS;
+        if ( baseline.save_name ) {
+            char            *path = baseline_path(&baseline, baseline.save_name);
             
-                if ( io_driver->seek(&out_fh, fp) < 0 ) {
-                    fprintf(stderr, "ERROR:  unable to seek to (..., %lu, ...) in output file (errno = %d)\n", j, errno);
-                    exit(errno);
-                }
-                n_bytes = io_driver->write(&out_fh, v2, v_len);
-                if ( n_bytes <= 0 ) {
-                    fprintf(stderr, "ERROR:  unable to write (..., %lu, ...) to output file (errno = %d)\n", j, errno);
-                    exit(errno);
-                }
+            if ( ! path || ! baseline_save(path, key, samples, n_repeats) ) {
+                fprintf(stderr, "ERROR:  unable to save baseline '%s' (errno = %d)\n", baseline.save_name, errno);
+                exit(errno);
             }
-            free((void*)v1);
-            break;
+            printf("INFO:  saved %d sample(s) to baseline %s\n", n_repeats, path);
+            free(path);
         }
-    
     }
-    io_driver->close(&out_fh);
-    clock_gettime(CLOCK_MONOTONIC, &timer[1]);
-    dt = (timer[1].tv_sec - timer[0].tv_sec) + 1e-9 * (timer[1].tv_nsec - timer[0].tv_nsec);
-    
-    printf("INFO:  elapsed file processing time %.6lf s\n", dt);
     
-    io_driver->close(&in_fh);
+    if ( transform.should_read ) in_driver->close(&transform.in_fh);
     return rc;
 }
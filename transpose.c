@@ -0,0 +1,760 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <dlfcn.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "transpose.h"
+
+//
+
+/*
+ * Edge length (in words) of the square tiles used by the blocked kernels:
+ * two 32 x 32 tiles of doubles fit comfortably in a 32 KiB L1 cache.
+ */
+#define TRANSPOSE_TILE              32
+
+/*
+ * The recursive kernel stops dividing at this size.
+ */
+#define TRANSPOSE_OBLIVIOUS_LEAF    16
+
+int transpose_prefetch_distance = TRANSPOSE_PREFETCH_DEFAULT;
+
+/*
+ * Start loading the source rows of the tile prefetch_distance tiles further
+ * along k while the current tile (rows k0.., columns i0..i1) is transposed:
+ * each tile reads TRANSPOSE_TILE rows n1 words apart, a stride the hardware
+ * prefetchers stop following once n1 is large.
+ */
+static inline void
+transpose_prefetch_tile(
+    const double    *src,
+    unsigned long   n1,
+    unsigned long   nk,
+    unsigned long   i0,
+    unsigned long   i1,
+    unsigned long   k0
+)
+{
+    unsigned long   k, k_end;
+
+    if ( transpose_prefetch_distance <= 0 ) return;
+    k = k0 + transpose_prefetch_distance * TRANSPOSE_TILE;
+    if ( k >= nk ) return;
+    k_end = (k + TRANSPOSE_TILE < nk) ? (k + TRANSPOSE_TILE) : nk;
+    for ( ; k < k_end; k++ ) {
+        const char  *p = (const char*)(src + k * n1 + i0), *p_end = (const char*)(src + k * n1 + i1);
+
+        for ( ; p < p_end; p += 64 ) __builtin_prefetch(p, 0, 3);
+    }
+}
+
+static inline void
+transpose_block_scalar(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk,
+    unsigned long   i0,
+    unsigned long   i1,
+    unsigned long   k0,
+    unsigned long   k1
+)
+{
+    unsigned long   i, k;
+
+    for ( i = i0; i < i1; i++ ) {
+        for ( k = k0; k < k1; k++ ) dst[i * nk + k] = src[k * n1 + i];
+    }
+}
+
+//
+
+void
+transpose_scalar(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk
+)
+{
+    transpose_block_scalar(src, dst, n1, nk, 0, n1, 0, nk);
+}
+
+//
+
+void
+transpose_tiled(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk
+)
+{
+    unsigned long   i0, k0, i1, k1;
+
+    for ( i0 = 0; i0 < n1; i0 = i1 ) {
+        i1 = (i0 + TRANSPOSE_TILE < n1) ? (i0 + TRANSPOSE_TILE) : n1;
+        for ( k0 = 0; k0 < nk; k0 = k1 ) {
+            k1 = (k0 + TRANSPOSE_TILE < nk) ? (k0 + TRANSPOSE_TILE) : nk;
+            transpose_prefetch_tile(src, n1, nk, i0, i1, k0);
+            transpose_block_scalar(src, dst, n1, nk, i0, i1, k0, k1);
+        }
+    }
+}
+
+//
+
+#if defined(__AVX__)
+#define TRANSPOSE_SIMD_WIDTH        4
+
+/*
+ * 4 x 4 register transpose:  rows k..k+3 of src become rows i..i+3 of dst.
+ */
+static inline void
+transpose_simd_block(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk,
+    unsigned long   i,
+    unsigned long   k
+)
+{
+    const double    *s = src + k * n1 + i;
+    double          *d = dst + i * nk + k;
+    __m256d         r0 = _mm256_loadu_pd(s), r1 = _mm256_loadu_pd(s + n1),
+                    r2 = _mm256_loadu_pd(s + 2 * n1), r3 = _mm256_loadu_pd(s + 3 * n1);
+    __m256d         t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1),
+                    t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+
+    _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(d + nk, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(d + 2 * nk, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(d + 3 * nk, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+#elif defined(__SSE2__)
+#define TRANSPOSE_SIMD_WIDTH        2
+
+/*
+ * 2 x 2 register transpose:  rows k, k+1 of src become rows i, i+1 of dst.
+ */
+static inline void
+transpose_simd_block(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk,
+    unsigned long   i,
+    unsigned long   k
+)
+{
+    const double    *s = src + k * n1 + i;
+    double          *d = dst + i * nk + k;
+    __m128d         r0 = _mm_loadu_pd(s), r1 = _mm_loadu_pd(s + n1);
+
+    _mm_storeu_pd(d, _mm_unpacklo_pd(r0, r1));
+    _mm_storeu_pd(d + nk, _mm_unpackhi_pd(r0, r1));
+}
+
+#endif
+
+void
+transpose_simd(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk
+)
+{
+#ifdef TRANSPOSE_SIMD_WIDTH
+    unsigned long   i0, k0, i1, k1, i, k;
+
+    for ( i0 = 0; i0 < n1; i0 = i1 ) {
+        i1 = (i0 + TRANSPOSE_TILE < n1) ? (i0 + TRANSPOSE_TILE) : n1;
+        for ( k0 = 0; k0 < nk; k0 = k1 ) {
+            k1 = (k0 + TRANSPOSE_TILE < nk) ? (k0 + TRANSPOSE_TILE) : nk;
+            transpose_prefetch_tile(src, n1, nk, i0, i1, k0);
+            for ( i = i0; i + TRANSPOSE_SIMD_WIDTH <= i1; i += TRANSPOSE_SIMD_WIDTH ) {
+                for ( k = k0; k + TRANSPOSE_SIMD_WIDTH <= k1; k += TRANSPOSE_SIMD_WIDTH ) {
+                    transpose_simd_block(src, dst, n1, nk, i, k);
+                }
+                //
+                // Leftover k columns for these rows:
+                //
+                transpose_block_scalar(src, dst, n1, nk, i, i + TRANSPOSE_SIMD_WIDTH, k, k1);
+            }
+            //
+            // Leftover i rows of the tile:
+            //
+            transpose_block_scalar(src, dst, n1, nk, i, i1, k0, k1);
+        }
+    }
+#else
+    transpose_tiled(src, dst, n1, nk);
+#endif
+}
+
+//
+
+static void
+transpose_oblivious_recurse(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk,
+    unsigned long   i0,
+    unsigned long   i1,
+    unsigned long   k0,
+    unsigned long   k1
+)
+{
+    if ( (i1 - i0 <= TRANSPOSE_OBLIVIOUS_LEAF) && (k1 - k0 <= TRANSPOSE_OBLIVIOUS_LEAF) ) {
+        transpose_block_scalar(src, dst, n1, nk, i0, i1, k0, k1);
+    } else if ( i1 - i0 >= k1 - k0 ) {
+        unsigned long   im = i0 + (i1 - i0) / 2;
+
+        transpose_oblivious_recurse(src, dst, n1, nk, i0, im, k0, k1);
+        transpose_oblivious_recurse(src, dst, n1, nk, im, i1, k0, k1);
+    } else {
+        unsigned long   km = k0 + (k1 - k0) / 2;
+
+        transpose_oblivious_recurse(src, dst, n1, nk, i0, i1, k0, km);
+        transpose_oblivious_recurse(src, dst, n1, nk, i0, i1, km, k1);
+    }
+}
+
+/*
+ * Cache-oblivious:  halve the larger dimension until the block is a leaf,
+ * so some level of the recursion fits each level of the cache hierarchy
+ * without a tuned tile size.
+ */
+void
+transpose_oblivious(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk
+)
+{
+    transpose_oblivious_recurse(src, dst, n1, nk, 0, n1, 0, nk);
+}
+
+//
+
+/*
+ * The word at position p = k * n1 + i moves to i * nk + k.  Square slabs
+ * swap across the diagonal; otherwise each permutation cycle is followed
+ * once, with a bitmap (one bit per word) marking the positions already
+ * placed.  Slabs with n1 or nk equal to 1 have the same layout either way.
+ */
+void
+transpose_in_place(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk
+)
+{
+    unsigned long   N = n1 * nk, p;
+    uint64_t        *done;
+
+    if ( (n1 == 1) || (nk == 1) ) return;
+    if ( n1 == nk ) {
+        unsigned long   i, k;
+
+        for ( i = 0; i < n1; i++ ) {
+            for ( k = i + 1; k < nk; k++ ) {
+                double  t = dst[k * n1 + i];
+
+                dst[k * n1 + i] = dst[i * nk + k];
+                dst[i * nk + k] = t;
+            }
+        }
+        return;
+    }
+    if ( ! (done = (uint64_t*)calloc((N + 63) / 64, sizeof(uint64_t))) ) {
+        fprintf(stderr, "ERROR:  unable to allocate in-place transpose bitmap\n");
+        exit(ENOMEM);
+    }
+    //
+    // The first and last words never move:
+    //
+    for ( p = 1; p < N - 1; p++ ) {
+        unsigned long   cur = p;
+        double          carry;
+
+        if ( done[p / 64] & (1ULL << (p % 64)) ) continue;
+        carry = dst[p];
+        do {
+            unsigned long   next = (cur % n1) * nk + (cur / n1);
+            double          t = dst[next];
+
+            dst[next] = carry;
+            carry = t;
+            done[next / 64] |= 1ULL << (next % 64);
+            cur = next;
+        } while ( cur != p );
+    }
+    free((void*)done);
+}
+
+//
+
+/*
+ * Tiled SSE2 2 x 2 blocks whose stores bypass the cache (the destination is
+ * written once and not read back by the transpose), falling back to normal
+ * stores where a destination pair is not 16-byte aligned.
+ */
+void
+transpose_streaming(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk
+)
+{
+#if defined(__SSE2__)
+    unsigned long   i0, k0, i1, k1, i, k;
+
+    for ( i0 = 0; i0 < n1; i0 = i1 ) {
+        i1 = (i0 + TRANSPOSE_TILE < n1) ? (i0 + TRANSPOSE_TILE) : n1;
+        for ( k0 = 0; k0 < nk; k0 = k1 ) {
+            k1 = (k0 + TRANSPOSE_TILE < nk) ? (k0 + TRANSPOSE_TILE) : nk;
+            transpose_prefetch_tile(src, n1, nk, i0, i1, k0);
+            for ( i = i0; i + 2 <= i1; i += 2 ) {
+                for ( k = k0; k + 2 <= k1; k += 2 ) {
+                    const double    *s = src + k * n1 + i;
+                    double          *d = dst + i * nk + k;
+                    __m128d         r0 = _mm_loadu_pd(s), r1 = _mm_loadu_pd(s + n1);
+
+                    if ( ((uintptr_t)d & 0xf) == 0 ) {
+                        _mm_stream_pd(d, _mm_unpacklo_pd(r0, r1));
+                    } else {
+                        _mm_storeu_pd(d, _mm_unpacklo_pd(r0, r1));
+                    }
+                    if ( ((uintptr_t)(d + nk) & 0xf) == 0 ) {
+                        _mm_stream_pd(d + nk, _mm_unpackhi_pd(r0, r1));
+                    } else {
+                        _mm_storeu_pd(d + nk, _mm_unpackhi_pd(r0, r1));
+                    }
+                }
+                transpose_block_scalar(src, dst, n1, nk, i, i + 2, k, k1);
+            }
+            transpose_block_scalar(src, dst, n1, nk, i, i1, k0, k1);
+        }
+    }
+    _mm_sfence();
+#else
+    transpose_tiled(src, dst, n1, nk);
+#endif
+}
+
+//
+
+/*
+ * Kernels specialized at compile time for a fixed, small n1:  the i loop has
+ * a constant trip count the compiler unrolls completely, and k is register
+ * blocked four at a time so each destination row receives four adjacent
+ * words per pass.  Skinny slabs are where the generic tiled loops spend the
+ * most time on loop overhead and edge handling.
+ */
+#if defined(__clang__)
+#define TRANSPOSE_UNROLL            _Pragma("unroll")
+#elif defined(__GNUC__) && (__GNUC__ >= 8)
+#define TRANSPOSE_UNROLL            _Pragma("GCC unroll 128")
+#else
+#define TRANSPOSE_UNROLL
+#endif
+
+#define TRANSPOSE_FIXED_N1_LIST(X) \
+    X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) \
+    X(9) X(10) X(11) X(12) X(13) X(14) X(15) X(16) \
+    X(17) X(18) X(19) X(20) X(21) X(22) X(23) X(24) \
+    X(25) X(26) X(27) X(28) X(29) X(30) X(31) X(32) \
+    X(48) X(64) X(67) X(96) X(128)
+
+#define TRANSPOSE_FIXED_N1_MAX      128
+
+#define TRANSPOSE_FIXED_N1_DEFINE(N) \
+static void \
+transpose_n1_##N( \
+    const double    *src, \
+    double          *dst, \
+    unsigned long   nk \
+) \
+{ \
+    unsigned long   i, k; \
+    \
+    for ( k = 0; k + 4 <= nk; k += 4 ) { \
+        const double    *s = src + k * N; \
+        double          *d = dst + k; \
+        \
+        TRANSPOSE_UNROLL \
+        for ( i = 0; i < N; i++ ) { \
+            double      w0 = s[i], w1 = s[N + i], w2 = s[2 * N + i], w3 = s[3 * N + i]; \
+            \
+            d[i * nk] = w0; \
+            d[i * nk + 1] = w1; \
+            d[i * nk + 2] = w2; \
+            d[i * nk + 3] = w3; \
+        } \
+    } \
+    for ( ; k < nk; k++ ) { \
+        TRANSPOSE_UNROLL \
+        for ( i = 0; i < N; i++ ) dst[i * nk + k] = src[k * N + i]; \
+    } \
+}
+
+TRANSPOSE_FIXED_N1_LIST(TRANSPOSE_FIXED_N1_DEFINE)
+
+typedef void (*transpose_fixed_n1_fn_t)(const double *src, double *dst, unsigned long nk);
+
+#define TRANSPOSE_FIXED_N1_ENTRY(N) [N] = transpose_n1_##N,
+
+static transpose_fixed_n1_fn_t transpose_fixed_n1[TRANSPOSE_FIXED_N1_MAX + 1] = {
+        TRANSPOSE_FIXED_N1_LIST(TRANSPOSE_FIXED_N1_ENTRY)
+    };
+
+/*
+ * Dispatch on n1 to a specialized kernel, falling back to the tiled kernel
+ * for the sizes without one.
+ */
+void
+transpose_small_n1(
+    const double    *src,
+    double          *dst,
+    unsigned long   n1,
+    unsigned long   nk
+)
+{
+    if ( (n1 <= TRANSPOSE_FIXED_N1_MAX) && transpose_fixed_n1[n1] ) {
+        transpose_fixed_n1[n1](src, dst, nk);
+    } else {
+        transpose_tiled(src, dst, n1, nk);
+    }
+}
+
+bool
+transpose_small_n1_is_specialized(
+    unsigned long   n1
+)
+{
+    return ((n1 <= TRANSPOSE_FIXED_N1_MAX) && transpose_fixed_n1[n1]) ? true : false;
+}
+
+//
+
+transpose_kernel_t transpose_kernels[] = {
+        { "scalar",     transpose_scalar,       false,  "i-then-k loops over the whole slab" },
+        { "tiled",      transpose_tiled,        false,  "32 x 32 cache-blocked tiles" },
+#if defined(__AVX__)
+        { "simd",       transpose_simd,         false,  "tiles of AVX 4 x 4 register transposes" },
+#elif defined(__SSE2__)
+        { "simd",       transpose_simd,         false,  "tiles of SSE2 2 x 2 register transposes" },
+#else
+        { "simd",       transpose_simd,         false,  "no SIMD support in this build, same as tiled" },
+#endif
+        { "oblivious",  transpose_oblivious,    false,  "cache-oblivious recursive halving" },
+        { "in_place",   transpose_in_place,     true,   "cycle-following within the source buffer" },
+        { "streaming",  transpose_streaming,    false,  "tiled SSE2 blocks with non-temporal stores" },
+        { "small_n1",   transpose_small_n1,     false,  "unrolled kernels for n1 = 1-32, 48, 64, 67, 96, 128; tiled otherwise" },
+        { "jit",        NULL,                   false,  "small_n1 body compiled at run time for the slab's n1 and cached" },
+        { NULL,         NULL,                   false,  NULL }
+    };
+
+transpose_kernel_t*
+transpose_kernel_lookup(
+    const char      *name
+)
+{
+    transpose_kernel_t  *K = transpose_kernels;
+
+    while ( K->name ) {
+        if ( strcasecmp(K->name, name) == 0 ) return K;
+        K++;
+    }
+    return NULL;
+}
+
+//
+
+static inline double
+transpose_stream_now(void)
+{
+    struct timespec     t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+/*
+ * The first pass of each kernel faults the pages in and is not counted.
+ */
+bool
+transpose_stream_measure(
+    size_t              n_words,
+    int                 n_passes,
+    transpose_stream_t  *result
+)
+{
+    double              *a, *b, *c, q = 3.0, t0, dt;
+    double              best_copy = 0.0, best_triad = 0.0;
+    size_t              i;
+    int                 pass;
+
+    if ( n_words == 0 ) n_words = 1;
+    a = (double*)malloc(3 * sizeof(double) * n_words);
+    if ( ! a ) return false;
+    b = a + n_words;
+    c = b + n_words;
+    for ( i = 0; i < n_words; i++ ) {
+        a[i] = 1.0;
+        b[i] = 2.0;
+        c[i] = 0.0;
+    }
+    for ( pass = 0; pass <= n_passes; pass++ ) {
+        t0 = transpose_stream_now();
+        for ( i = 0; i < n_words; i++ ) c[i] = a[i];
+        dt = transpose_stream_now() - t0;
+        if ( (pass > 0) && ((best_copy == 0.0) || (dt < best_copy)) ) best_copy = dt;
+
+        t0 = transpose_stream_now();
+        for ( i = 0; i < n_words; i++ ) a[i] = b[i] + q * c[i];
+        dt = transpose_stream_now() - t0;
+        if ( (pass > 0) && ((best_triad == 0.0) || (dt < best_triad)) ) best_triad = dt;
+    }
+    result->n_words = n_words;
+    result->copy = (best_copy > 0.0) ? (2 * sizeof(double) * n_words / best_copy / 1e9) : 0.0;
+    result->triad = (best_triad > 0.0) ? (3 * sizeof(double) * n_words / best_triad / 1e9) : 0.0;
+
+    //
+    // Keep the compiler from discarding the loops:
+    //
+    if ( a[n_words / 2] < 0.0 ) fprintf(stderr, "%g\n", a[n_words / 2]);
+    free((void*)a);
+    return true;
+}
+
+//
+
+/*
+ * Run-time specialization:  C source for the exact (n1, nk) shape is
+ * written to the cache directory, compiled into a shared object and loaded.
+ * The object's name carries a hash of the source, the compiler command and
+ * the CPU model and flags, so a cache shared across node types (e.g. a home
+ * directory) never hands out an object built for a different CPU.
+ */
+#define TRANSPOSE_JIT_SYMBOL        "transpose_jit_kernel"
+#define TRANSPOSE_JIT_CFLAGS        "-O3", "-march=native", "-shared", "-fPIC"
+#define TRANSPOSE_JIT_CFLAGS_STR    "-O3 -march=native -shared -fPIC"
+
+extern char **environ;
+
+static uint64_t
+transpose_jit_hash(
+    uint64_t        h,
+    const char      *s
+)
+{
+    while ( *s ) {
+        h ^= (unsigned char)*s++;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/*
+ * Fold the first processor's model name and feature flags into the hash.
+ */
+static uint64_t
+transpose_jit_hash_cpu(
+    uint64_t        h
+)
+{
+    FILE            *fptr = fopen("/proc/cpuinfo", "r");
+    char            line[8192];
+    int             n_found = 0;
+
+    if ( ! fptr ) return h;
+    while ( (n_found < 2) && fgets(line, sizeof(line), fptr) ) {
+        if ( (strncmp(line, "model name", 10) == 0) || (strncmp(line, "flags", 5) == 0) || (strncmp(line, "Features", 8) == 0) ) {
+            h = transpose_jit_hash(h, line);
+            n_found++;
+        }
+    }
+    fclose(fptr);
+    return h;
+}
+
+static bool
+transpose_jit_mkdirs(
+    char            *path
+)
+{
+    char            *p = path;
+
+    while ( (p = strchr(p + 1, '/')) ) {
+        *p = '\0';
+        if ( (mkdir(path, 0755) != 0) && (errno != EEXIST) ) {
+            *p = '/';
+            return false;
+        }
+        *p = '/';
+    }
+    return ((mkdir(path, 0755) == 0) || (errno == EEXIST)) ? true : false;
+}
+
+/*
+ * The generated kernel is the small_n1 body -- four source rows at a time
+ * held in registers and stored as four-word runs of the destination rows,
+ * with the loop over i fully unrolled -- for the constant n1.  nk is left a
+ * run-time argument:  folding it in as well measured slower, not faster, so
+ * one object serves every nk (and every k tile) for an n1.  A call with
+ * another n1 takes the plain loops.
+ */
+static int
+transpose_jit_source(
+    char            *buffer,
+    size_t          buffer_len,
+    unsigned long   n1
+)
+{
+    return snprintf(buffer, buffer_len,
+            "/* generated transpose kernel for n1 = %lu, double */\n"
+            "#define N1 %luUL\n"
+            "void\n"
+            "%s(const double *restrict src, double *restrict dst, unsigned long n1, unsigned long nk)\n"
+            "{\n"
+            "    unsigned long i, k;\n"
+            "    if ( n1 != N1 ) {\n"
+            "        for ( i = 0; i < n1; i++ ) for ( k = 0; k < nk; k++ ) dst[i * nk + k] = src[k * n1 + i];\n"
+            "        return;\n"
+            "    }\n"
+            "    for ( k = 0; k + 4 <= nk; k += 4 ) {\n"
+            "        const double *s = src + k * N1;\n"
+            "        double *d = dst + k;\n"
+            "#pragma GCC unroll 128\n"
+            "        for ( i = 0; i < N1; i++ ) {\n"
+            "            double w0 = s[i], w1 = s[N1 + i], w2 = s[2 * N1 + i], w3 = s[3 * N1 + i];\n"
+            "            d[i * nk] = w0;\n"
+            "            d[i * nk + 1] = w1;\n"
+            "            d[i * nk + 2] = w2;\n"
+            "            d[i * nk + 3] = w3;\n"
+            "        }\n"
+            "    }\n"
+            "    for ( ; k < nk; k++ ) {\n"
+            "        for ( i = 0; i < N1; i++ ) dst[i * nk + k] = src[k * N1 + i];\n"
+            "    }\n"
+            "}\n",
+            n1, n1, TRANSPOSE_JIT_SYMBOL);
+}
+
+transpose_kernel_fn_t
+transpose_jit_compile(
+    unsigned long   n1,
+    const char      *cache_dir,
+    double          *compile_seconds
+)
+{
+    const char      *cc = getenv("CC");
+    char            source[4096], dir[4096], path[4200], so_path[4200], tmp_path[4200];
+    uint64_t        h = 0xcbf29ce484222325ULL;
+    struct stat     finfo;
+    void            *dl;
+    transpose_kernel_fn_t   fn;
+
+    if ( compile_seconds ) *compile_seconds = 0.0;
+    if ( ! cc || ! *cc ) cc = "cc";
+    if ( cache_dir ) {
+        snprintf(dir, sizeof(dir), "%s", cache_dir);
+    } else if ( getenv("XDG_CACHE_HOME") && *getenv("XDG_CACHE_HOME") ) {
+        snprintf(dir, sizeof(dir), "%s/sapt-io-test", getenv("XDG_CACHE_HOME"));
+    } else if ( getenv("HOME") && *getenv("HOME") ) {
+        snprintf(dir, sizeof(dir), "%s/.cache/sapt-io-test", getenv("HOME"));
+    } else {
+        fprintf(stderr, "WARNING:  no cache directory for jit kernels (HOME is not set)\n");
+        return NULL;
+    }
+    if ( ! transpose_jit_mkdirs(dir) ) {
+        fprintf(stderr, "WARNING:  unable to create jit cache directory %s (errno = %d)\n", dir, errno);
+        return NULL;
+    }
+
+    transpose_jit_source(source, sizeof(source), n1);
+    h = transpose_jit_hash(h, source);
+    h = transpose_jit_hash(h, cc);
+    h = transpose_jit_hash(h, TRANSPOSE_JIT_CFLAGS_STR);
+    h = transpose_jit_hash_cpu(h);
+    snprintf(so_path, sizeof(so_path), "%s/transpose_%lu_d_%016llx.so", dir, n1, (unsigned long long)h);
+
+    if ( stat(so_path, &finfo) != 0 ) {
+        struct timespec t0, t1;
+        FILE            *fptr;
+        pid_t           pid;
+        int             status;
+        char            *argv[] = { (char*)cc, TRANSPOSE_JIT_CFLAGS, "-o", tmp_path, path, NULL };
+
+        //
+        // Concurrent processes each build their own copy and rename it into
+        // place, so a partially-written object is never loaded:
+        //
+        snprintf(path, sizeof(path), "%s/transpose_%lu_d_%016llx.%d.c", dir, n1, (unsigned long long)h, (int)getpid());
+        snprintf(tmp_path, sizeof(tmp_path), "%s/transpose_%lu_d_%016llx.%d.so", dir, n1, (unsigned long long)h, (int)getpid());
+        if ( ! (fptr = fopen(path, "w")) ) {
+            fprintf(stderr, "WARNING:  unable to write jit source %s (errno = %d)\n", path, errno);
+            return NULL;
+        }
+        fputs(source, fptr);
+        fclose(fptr);
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        if ( (errno = posix_spawnp(&pid, cc, NULL, NULL, argv, environ)) != 0 ) {
+            fprintf(stderr, "WARNING:  unable to run jit compiler %s (errno = %d)\n", cc, errno);
+            unlink(path);
+            return NULL;
+        }
+        while ( (waitpid(pid, &status, 0) < 0) && (errno == EINTR) );
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        unlink(path);
+        if ( ! WIFEXITED(status) || WEXITSTATUS(status) ) {
+            fprintf(stderr, "WARNING:  jit compile of %s failed: %s %s\n", path, cc, TRANSPOSE_JIT_CFLAGS_STR);
+            unlink(tmp_path);
+            return NULL;
+        }
+        if ( rename(tmp_path, so_path) != 0 ) {
+            fprintf(stderr, "WARNING:  unable to move jit kernel into place at %s (errno = %d)\n", so_path, errno);
+            unlink(tmp_path);
+            return NULL;
+        }
+        if ( compile_seconds ) *compile_seconds = (t1.tv_sec - t0.tv_sec) + 1e-9 * (t1.tv_nsec - t0.tv_nsec);
+    }
+
+    if ( ! (dl = dlopen(so_path, RTLD_NOW | RTLD_LOCAL)) ) {
+        fprintf(stderr, "WARNING:  unable to load jit kernel %s: %s\n", so_path, dlerror());
+        return NULL;
+    }
+    if ( ! (fn = (transpose_kernel_fn_t)dlsym(dl, TRANSPOSE_JIT_SYMBOL)) ) {
+        fprintf(stderr, "WARNING:  no %s in jit kernel %s\n", TRANSPOSE_JIT_SYMBOL, so_path);
+        dlclose(dl);
+        return NULL;
+    }
+    return fn;
+}
@@ -0,0 +1,84 @@
+
+#ifndef __TRANSPOSE_H__
+#define __TRANSPOSE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * In-memory slab transpose kernels:  src holds nk rows of n1 words (the
+ * jki-ordered input, k-major) and dst receives n1 rows of nk words (the
+ * jik-ordered output, i-major), i.e. dst[i * nk + k] = src[k * n1 + i].
+ *
+ * Kernels flagged in_place must be called with dst == src and leave the
+ * transposed data in src.  Kernels with a NULL fn are produced at run time
+ * for a given n1 (see transpose_jit_compile()).
+ */
+typedef void (*transpose_kernel_fn_t)(const double *src, double *dst, unsigned long n1, unsigned long nk);
+
+typedef struct {
+    const char              *name;
+    transpose_kernel_fn_t   fn;
+    bool                    in_place;
+    const char              *description;
+} transpose_kernel_t;
+
+/*
+ * NULL-terminated table of all kernels; the first is the scalar reference.
+ */
+extern transpose_kernel_t transpose_kernels[];
+
+/*
+ * How many tiles ahead (along k) the blocked kernels -- tiled, simd and
+ * streaming -- prefetch their source rows; 0 disables the prefetch.
+ */
+#define TRANSPOSE_PREFETCH_DEFAULT  1
+
+extern int transpose_prefetch_distance;
+
+/*
+ * Returns the kernel with the given name (case-insensitive) or NULL.
+ */
+transpose_kernel_t* transpose_kernel_lookup(const char *name);
+
+/*
+ * STREAM-style memory bandwidth reference:  the best-of-n_passes copy
+ * (c[i] = a[i], 16 bytes per element) and triad (a[i] = b[i] + q * c[i],
+ * 24 bytes per element) rates over arrays of n_words doubles, in GB/s.
+ * A transpose moves the same bytes as a copy, so the copy rate is the
+ * ceiling for any kernel.
+ */
+typedef struct {
+    size_t                  n_words;
+    double                  copy, triad;
+} transpose_stream_t;
+
+#define TRANSPOSE_STREAM_DEFAULT_BYTES  ((size_t)64 * 1024 * 1024)
+#define TRANSPOSE_STREAM_PASSES         10
+
+bool transpose_stream_measure(size_t n_words, int n_passes, transpose_stream_t *result);
+
+void transpose_scalar(const double *src, double *dst, unsigned long n1, unsigned long nk);
+void transpose_tiled(const double *src, double *dst, unsigned long n1, unsigned long nk);
+void transpose_simd(const double *src, double *dst, unsigned long n1, unsigned long nk);
+void transpose_oblivious(const double *src, double *dst, unsigned long n1, unsigned long nk);
+void transpose_in_place(const double *src, double *dst, unsigned long n1, unsigned long nk);
+void transpose_streaming(const double *src, double *dst, unsigned long n1, unsigned long nk);
+void transpose_small_n1(const double *src, double *dst, unsigned long n1, unsigned long nk);
+
+/*
+ * True if transpose_small_n1() has a kernel specialized for this n1.
+ */
+bool transpose_small_n1_is_specialized(unsigned long n1);
+
+/*
+ * Compile (or find in the cache) a kernel specialized for this n1, any nk,
+ * and load it; the "jit" entry of transpose_kernels has no fn of its own
+ * and stands for the result.  cache_dir may be NULL for the default
+ * ($XDG_CACHE_HOME or ~/.cache, under sapt-io-test).  The compiler is $CC
+ * or cc.  compile_seconds (if not NULL) is 0 when the cached object was
+ * used.  Returns NULL, with a warning printed, on any failure.
+ */
+transpose_kernel_fn_t transpose_jit_compile(unsigned long n1, const char *cache_dir, double *compile_seconds);
+
+#endif /* __TRANSPOSE_H__ */
@@ -0,0 +1,392 @@
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <getopt.h>
+#include <time.h>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC
+#endif
+
+#include "transpose.h"
+
+//
+
+/*
+ * Default grid of (n1, n3) slab shapes:  skinny slabs with a small first
+ * index (as in SAPT, n1 = 67), powers of two and their neighbors (which
+ * alias in the cache), and wide-and-short slabs.
+ */
+static unsigned long bench_default_shapes[][2] = {
+        { 1, 100000 }, { 2, 50000 }, { 3, 33333 }, { 4, 25000 },
+        { 7, 14281 }, { 8, 12500 }, { 16, 6250 }, { 31, 3225 },
+        { 32, 3125 }, { 48, 2083 }, { 64, 1563 }, { 67, 500 },
+        { 67, 5000 }, { 100, 1000 }, { 128, 128 }, { 255, 257 },
+        { 256, 256 }, { 1000, 1000 }, { 1024, 1024 }, { 2048, 2048 },
+        { 5000, 67 }, { 100000, 2 },
+        { 0, 0 }
+    };
+
+#define BENCH_MAX_SHAPES            256
+#define BENCH_MAX_KERNELS           64
+
+typedef struct {
+    int             n_warmup, n_repeat;
+    double          min_time;
+    int             cpu;
+    size_t          stream_bytes;
+    double          stream_copy;
+} bench_config_t;
+
+static inline double
+bench_now(void)
+{
+    struct timespec     t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static inline uint64_t
+bench_cycles(void)
+{
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+//
+
+static struct option bench_options[] = {
+        { "help",       no_argument,       0, 'h' },
+        { "kernel",     required_argument, 0, 'k' },
+        { "shape",      required_argument, 0, 's' },
+        { "warmup",     required_argument, 0, 'w' },
+        { "repeat",     required_argument, 0, 'r' },
+        { "min-time",   required_argument, 0, 't' },
+        { "cpu",        required_argument, 0, 'c' },
+        { "calibrate",  required_argument, 0, 'C' },
+        { "prefetch-distance", required_argument, 0, 'p' },
+        { NULL, 0, 0, 0 }
+    };
+static char *bench_options_str = "hk:s:w:r:t:c:C:p:";
+
+void
+usage(
+    const char  *exe
+)
+{
+    transpose_kernel_t  *K = transpose_kernels;
+
+    printf(
+            "usage:\n\n"
+            "    %s {options}\n\n"
+            "  options:\n\n"
+            "    -h/--help                    show this information\n"
+            "    -k <kernel>,                 benchmark this kernel (repeat for more;\n"
+            "        --kernel=<kernel>          default all)\n"
+            "    -s <n1>x<n3>,                benchmark this slab shape (repeat for\n"
+            "        --shape=<n1>x<n3>          more; default a built-in grid)\n"
+            "    -w #, --warmup=#             untimed passes per measurement (default 2)\n"
+            "    -r #, --repeat=#             timed passes per measurement, the best\n"
+            "                                   is reported (default 5)\n"
+            "    -t <seconds>,                each timed pass repeats the kernel for\n"
+            "        --min-time=<seconds>       at least this long (default 0.05)\n"
+            "    -c #, --cpu=#                pin to this CPU (default the current\n"
+            "                                   one, -1 to not pin)\n"
+            "    -C <size>,                   size of each STREAM copy/triad array\n"
+            "        --calibrate=<size>         measured at startup as the bandwidth\n"
+            "                                   reference (default 64M, 0 to skip)\n"
+            "    -p #,                        tiles ahead the blocked kernels prefetch\n"
+            "        --prefetch-distance=#      source rows (default %d, 0 disables)\n\n"
+            "  <kernel>:\n",
+            exe, TRANSPOSE_PREFETCH_DEFAULT);
+    while ( K->name ) {
+        printf("    %-15s %s\n", K->name, K->description);
+        K++;
+    }
+    printf("\n");
+}
+
+//
+
+/*
+ * Time one kernel on one shape; returns false if its output does not match
+ * the scalar reference.
+ */
+bool
+bench_kernel(
+    transpose_kernel_t  *K,
+    bench_config_t      *cfg,
+    unsigned long       n1,
+    unsigned long       n3,
+    const double        *src,
+    double              *dst,
+    const double        *expect
+)
+{
+    size_t              N = n1 * n3, bytes = 2 * sizeof(double) * N;
+    unsigned long       iters = 1, it;
+    double              best_dt = 0.0, t0, dt;
+    uint64_t            best_cycles = 0, c0;
+    bool                is_ok;
+    int                 pass;
+
+    //
+    // Check the result of a single call:
+    //
+    if ( K->in_place ) {
+        memcpy(dst, src, sizeof(double) * N);
+        K->fn(dst, dst, n1, n3);
+    } else {
+        K->fn(src, dst, n1, n3);
+    }
+    is_ok = (memcmp(dst, expect, sizeof(double) * N) == 0) ? true : false;
+
+    //
+    // Size the iteration count so a timed pass lasts at least min_time, then
+    // run the untimed warmup passes:
+    //
+    while ( 1 ) {
+        t0 = bench_now();
+        for ( it = 0; it < iters; it++ ) K->fn(K->in_place ? dst : src, dst, n1, n3);
+        dt = bench_now() - t0;
+        if ( dt >= cfg->min_time ) break;
+        iters = (dt > 0.0) ? (unsigned long)(1.2 * iters * cfg->min_time / dt) + 1 : 2 * iters;
+    }
+    for ( pass = 0; pass < cfg->n_warmup; pass++ ) {
+        for ( it = 0; it < iters; it++ ) K->fn(K->in_place ? dst : src, dst, n1, n3);
+    }
+    for ( pass = 0; pass < cfg->n_repeat; pass++ ) {
+        c0 = bench_cycles();
+        t0 = bench_now();
+        for ( it = 0; it < iters; it++ ) K->fn(K->in_place ? dst : src, dst, n1, n3);
+        dt = bench_now() - t0;
+        c0 = bench_cycles() - c0;
+        if ( (pass == 0) || (dt < best_dt) ) {
+            best_dt = dt;
+            best_cycles = c0;
+        }
+    }
+    printf("%-12s %8lu %8lu %10.3lf", K->name, n1, n3, bytes * iters / best_dt / 1e9);
+#ifdef HAVE_TSC
+    printf(" %12.3lf", (double)best_cycles / ((double)N * iters));
+#else
+    printf(" %12s", "n/a");
+#endif
+    if ( cfg->stream_copy > 0.0 ) printf(" %7.1lf%%", 100.0 * bytes * iters / best_dt / 1e9 / cfg->stream_copy);
+    printf("  %s\n", is_ok ? "ok" : "MISMATCH");
+    return is_ok;
+}
+
+//
+
+int
+main(
+    int         argc,
+    char*       argv[]
+)
+{
+    int                 opt_char, rc = 0;
+    bench_config_t      cfg = { 2, 5, 0.05, -2, TRANSPOSE_STREAM_DEFAULT_BYTES, 0.0 };
+    transpose_kernel_t  *kernels[BENCH_MAX_KERNELS];
+    int                 n_kernels = 0, k;
+    unsigned long       shapes[BENCH_MAX_SHAPES][2];
+    int                 n_shapes = 0, s;
+    size_t              max_N = 0;
+    double              *src, *dst, *expect;
+
+    while ( (opt_char = getopt_long(argc, argv, bench_options_str, bench_options, NULL)) != -1 ) {
+        switch ( opt_char ) {
+            case 'h':
+                usage(argv[0]);
+                exit(0);
+
+            case 'k': {
+                transpose_kernel_t  *K = transpose_kernel_lookup(optarg);
+
+                if ( ! K ) {
+                    fprintf(stderr, "ERROR:  unknown transpose kernel: %s\n", optarg);
+                    exit(EINVAL);
+                }
+                if ( n_kernels == BENCH_MAX_KERNELS ) {
+                    fprintf(stderr, "ERROR:  too many kernels (max %d)\n", BENCH_MAX_KERNELS);
+                    exit(EINVAL);
+                }
+                kernels[n_kernels++] = K;
+                break;
+            }
+
+            case 's': {
+                unsigned long       n1, n3;
+                char                x;
+
+                if ( (sscanf(optarg, "%lu%c%lu", &n1, &x, &n3) != 3) || ((x != 'x') && (x != 'X') && (x != ',')) || ! n1 || ! n3 ) {
+                    fprintf(stderr, "ERROR:  invalid shape: %s\n", optarg);
+                    exit(EINVAL);
+                }
+                if ( n_shapes == BENCH_MAX_SHAPES ) {
+                    fprintf(stderr, "ERROR:  too many shapes (max %d)\n", BENCH_MAX_SHAPES);
+                    exit(EINVAL);
+                }
+                shapes[n_shapes][0] = n1;
+                shapes[n_shapes++][1] = n3;
+                break;
+            }
+
+            case 'w':
+            case 'r':
+            case 'c':
+            case 'p': {
+                char                *eos = NULL;
+                long                v = strtol(optarg, &eos, 0);
+
+                if ( (eos == optarg) || *eos || (v < ((opt_char == 'c') ? -1 : (opt_char == 'r') ? 1 : 0)) ) {
+                    fprintf(stderr, "ERROR:  invalid value for -%c: %s\n", opt_char, optarg);
+                    exit(EINVAL);
+                }
+                if ( opt_char == 'w' ) cfg.n_warmup = v;
+                else if ( opt_char == 'r' ) cfg.n_repeat = v;
+                else if ( opt_char == 'p' ) transpose_prefetch_distance = v;
+                else cfg.cpu = v;
+                break;
+            }
+
+            case 'C': {
+                char                *eos = NULL;
+                unsigned long long  v = strtoull(optarg, &eos, 0);
+
+                switch ( (eos && *eos) ? *eos++ : '\0' ) {
+                    case 'T': case 't': v *= 1024;
+                    case 'G': case 'g': v *= 1024;
+                    case 'M': case 'm': v *= 1024;
+                    case 'K': case 'k': v *= 1024;
+                    case '\0':
+                        break;
+                    default:
+                        eos = optarg;
+                }
+                if ( (eos == optarg) || *eos ) {
+                    fprintf(stderr, "ERROR:  invalid STREAM array size: %s\n", optarg);
+                    exit(EINVAL);
+                }
+                cfg.stream_bytes = v;
+                break;
+            }
+
+            case 't': {
+                char                *eos = NULL;
+                double              v = strtod(optarg, &eos);
+
+                if ( (eos == optarg) || *eos || (v < 0.0) ) {
+                    fprintf(stderr, "ERROR:  invalid minimum time: %s\n", optarg);
+                    exit(EINVAL);
+                }
+                cfg.min_time = v;
+                break;
+            }
+
+            default:
+                usage(argv[0]);
+                exit(EINVAL);
+        }
+    }
+    if ( n_kernels == 0 ) {
+        transpose_kernel_t  *K = transpose_kernels;
+
+        while ( K->name && (n_kernels < BENCH_MAX_KERNELS) ) kernels[n_kernels++] = K++;
+    }
+    if ( n_shapes == 0 ) {
+        while ( bench_default_shapes[n_shapes][0] ) {
+            shapes[n_shapes][0] = bench_default_shapes[n_shapes][0];
+            shapes[n_shapes][1] = bench_default_shapes[n_shapes][1];
+            n_shapes++;
+        }
+    }
+    for ( s = 0; s < n_shapes; s++ ) {
+        if ( shapes[s][0] * shapes[s][1] > max_N ) max_N = shapes[s][0] * shapes[s][1];
+    }
+
+    //
+    // Pin to a single CPU so the timings are not disturbed by migration:
+    //
+    if ( cfg.cpu == -2 ) cfg.cpu = sched_getcpu();
+    if ( cfg.cpu >= 0 ) {
+        cpu_set_t           cpus;
+
+        CPU_ZERO(&cpus);
+        CPU_SET(cfg.cpu, &cpus);
+        if ( sched_setaffinity(0, sizeof(cpus), &cpus) != 0 ) {
+            fprintf(stderr, "ERROR:  unable to pin to cpu %d (errno = %d)\n", cfg.cpu, errno);
+            exit(errno);
+        }
+        printf("INFO:  pinned to cpu %d\n", cfg.cpu);
+    }
+
+    src = (double*)aligned_alloc(64, ((sizeof(double) * max_N + 63) / 64) * 64);
+    dst = (double*)aligned_alloc(64, ((sizeof(double) * max_N + 63) / 64) * 64);
+    expect = (double*)aligned_alloc(64, ((sizeof(double) * max_N + 63) / 64) * 64);
+    if ( ! src || ! dst || ! expect ) {
+        fprintf(stderr, "ERROR:  unable to allocate 3 x %lu words\n", (unsigned long)max_N);
+        exit(ENOMEM);
+    }
+
+    //
+    // Memory bandwidth reference for the "% of copy" column:
+    //
+    if ( cfg.stream_bytes ) {
+        transpose_stream_t  stream;
+
+        if ( ! transpose_stream_measure(cfg.stream_bytes / sizeof(double), TRANSPOSE_STREAM_PASSES, &stream) ) {
+            fprintf(stderr, "ERROR:  unable to allocate STREAM arrays of 3 x %lu bytes\n", (unsigned long)cfg.stream_bytes);
+            exit(ENOMEM);
+        }
+        printf("INFO:  STREAM copy %.3lf GB/s, triad %.3lf GB/s (3 x %lu words)\n", stream.copy, stream.triad, (unsigned long)stream.n_words);
+        cfg.stream_copy = stream.copy;
+    }
+
+    printf("%-12s %8s %8s %10s %12s", "kernel", "n1", "n3", "GB/s", "cycles/elem");
+    if ( cfg.stream_copy > 0.0 ) printf(" %8s", "%copy");
+    printf("\n");
+    for ( s = 0; s < n_shapes; s++ ) {
+        unsigned long       n1 = shapes[s][0], n3 = shapes[s][1], p;
+
+        for ( p = 0; p < n1 * n3; p++ ) src[p] = (double)p;
+        transpose_scalar(src, expect, n1, n3);
+        for ( k = 0; k < n_kernels; k++ ) {
+            transpose_kernel_t  *K = kernels[k], jit;
+
+            //
+            // A run-time kernel is compiled for each n1 (and found in the
+            // cache for the other shapes); the compile is not part of the
+            // timing:
+            //
+            if ( ! K->fn ) {
+                double          compile_seconds;
+
+                jit = *K;
+                if ( ! (jit.fn = transpose_jit_compile(n1, NULL, &compile_seconds)) ) {
+                    rc = 1;
+                    continue;
+                }
+                if ( compile_seconds > 0.0 ) printf("INFO:  %s kernel for n1 = %lu compiled in %.3lf s\n", K->name, n1, compile_seconds);
+                K = &jit;
+            }
+            if ( ! bench_kernel(K, &cfg, n1, n3, src, dst, expect) ) rc = 1;
+        }
+    }
+    free((void*)src);
+    free((void*)dst);
+    free((void*)expect);
+    return rc;
+}